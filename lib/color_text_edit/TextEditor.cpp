@@ -25,7 +25,7 @@ bool equals(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, Bi
 TextEditor::TextEditor()
     : mLineSpacing(1.0f), mUndoIndex(0), mTabSize(4), mOverwrite(false), mReadOnly(false),
       mWithinRender(false), mScrollToCursor(false), mScrollToTop(false), mTextChanged(false),
-      mColorizerEnabled(true), mTextStart(20.0f), mLeftMargin(10), mCursorPositionChanged(false),
+      mEditGeneration(0), mCleanUndoIndex(0), mColorizerEnabled(true), mTextStart(20.0f), mLeftMargin(10), mCursorPositionChanged(false),
       mColorRangeMin(0), mColorRangeMax(0), mSelectionMode(SelectionMode::Normal),
       mCheckComments(true), mLastClick(-1.0f), mHandleKeyboardInputs(true),
       mHandleMouseInputs(true), mIgnoreImGuiChild(false), mShowWhitespaces(true),
@@ -244,6 +244,8 @@ void TextEditor::DeleteRange(const Coordinates &aStart, const Coordinates &aEnd)
     }
 
     mTextChanged = true;
+
+    ++mEditGeneration;
 }
 
 int TextEditor::InsertTextAt(Coordinates & /* inout */ aWhere, const char *aValue)
@@ -290,6 +292,8 @@ int TextEditor::InsertTextAt(Coordinates & /* inout */ aWhere, const char *aValu
         }
 
         mTextChanged = true;
+
+        ++mEditGeneration;
     }
 
     return totalLines;
@@ -307,6 +311,10 @@ void TextEditor::AddUndo(UndoRecord &aValue)
     //aValue.mAfter.mCursorPosition.mColumn
     //	);
 
+    // The redo records that led back to the clean state are about to be dropped.
+    if (mCleanUndoIndex > mUndoIndex)
+        mCleanUndoIndex = -1;
+
     mUndoBuffer.resize((size_t)(mUndoIndex + 1));
     mUndoBuffer.back() = aValue;
     ++mUndoIndex;
@@ -596,6 +604,8 @@ void TextEditor::RemoveLine(int aStart, int aEnd)
     assert(!mLines.empty());
 
     mTextChanged = true;
+
+    ++mEditGeneration;
 }
 
 void TextEditor::RemoveLine(int aIndex)
@@ -626,6 +636,8 @@ void TextEditor::RemoveLine(int aIndex)
     assert(!mLines.empty());
 
     mTextChanged = true;
+
+    ++mEditGeneration;
 }
 
 TextEditor::Line &TextEditor::InsertLine(int aIndex)
@@ -1220,10 +1232,13 @@ void TextEditor::SetText(const std::string &aText)
     }
 
     mTextChanged = true;
+
+    ++mEditGeneration;
     mScrollToTop = true;
 
     mUndoBuffer.clear();
     mUndoIndex = 0;
+    mCleanUndoIndex = -1;
 
     Colorize();
 }
@@ -1251,10 +1266,13 @@ void TextEditor::SetTextLines(const std::vector<std::string> &aLines)
     }
 
     mTextChanged = true;
+
+    ++mEditGeneration;
     mScrollToTop = true;
 
     mUndoBuffer.clear();
     mUndoIndex = 0;
+    mCleanUndoIndex = -1;
 
     Colorize();
 }
@@ -1352,6 +1370,8 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 
                 mTextChanged = true;
 
+                ++mEditGeneration;
+
                 EnsureCursorVisible();
             }
 
@@ -1427,6 +1447,8 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 
     mTextChanged = true;
 
+    ++mEditGeneration;
+
     u.mAddedEnd = GetActualCursorCoordinates();
     u.mAfter = mState;
 
@@ -1521,6 +1543,9 @@ void TextEditor::InsertText(const char *aValue)
     if (aValue == nullptr)
         return;
 
+    // Not recorded in the undo buffer, so the history can no longer tell where it was clean.
+    mCleanUndoIndex = -1;
+
     auto pos = GetActualCursorCoordinates();
     auto start = std::min(pos, mState.mSelectionStart);
     int totalLines = pos.mLine - start.mLine;
@@ -1860,6 +1885,8 @@ void TextEditor::Delete()
 
         mTextChanged = true;
 
+        ++mEditGeneration;
+
         Colorize(pos.mLine, 1);
     }
 
@@ -1939,6 +1966,8 @@ void TextEditor::Backspace()
 
         mTextChanged = true;
 
+        ++mEditGeneration;
+
         EnsureCursorVisible();
         Colorize(mState.mCursorPosition.mLine, 1);
     }
@@ -2029,7 +2058,10 @@ void TextEditor::Paste()
         u.mAdded = clipText;
         u.mAddedStart = GetActualCursorCoordinates();
 
+        // Recorded below, unlike a plain InsertText(), so the clean mark stays valid.
+        const int cleanUndoIndex = mCleanUndoIndex;
         InsertText(clipText);
+        mCleanUndoIndex = cleanUndoIndex;
 
         u.mAddedEnd = GetActualCursorCoordinates();
         u.mAfter = mState;
@@ -2047,6 +2079,21 @@ bool TextEditor::CanRedo() const
     return !mReadOnly && mUndoIndex < (int)mUndoBuffer.size();
 }
 
+void TextEditor::MarkClean()
+{
+    mCleanUndoIndex = mUndoIndex;
+}
+
+bool TextEditor::IsClean() const
+{
+    return mCleanUndoIndex == mUndoIndex;
+}
+
+bool TextEditor::HasCleanMark() const
+{
+    return mCleanUndoIndex >= 0;
+}
+
 void TextEditor::Undo(int aSteps)
 {
     while (CanUndo() && aSteps-- > 0)
@@ -2204,6 +2251,8 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
     std::string buffer;
     std::cmatch results;
     std::string id;
+    std::vector<PaletteIndex> colors;
+    const bool commentSyntax = HasCommentSyntax();
 
     int endLine = std::max(0, std::min((int)mLines.size(), aToLine));
     for (int i = aFromLine; i < endLine; ++i)
@@ -2219,11 +2268,22 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
             auto &col = line[j];
             buffer[j] = col.mChar;
             col.mColorIndex = PaletteIndex::Default;
+            if (!commentSyntax)
+                col.mComment = col.mMultiLineComment = col.mPreprocessor = false;
         }
 
         const char *bufferBegin = &buffer.front();
         const char *bufferEnd = bufferBegin + buffer.size();
 
+        if (mLanguageDefinition.mTokenizeLine != nullptr)
+        {
+            colors.assign(line.size(), PaletteIndex::Default);
+            mLanguageDefinition.mTokenizeLine(bufferBegin, bufferEnd, colors.data());
+            for (size_t j = 0; j < line.size(); ++j)
+                line[j].mColorIndex = colors[j];
+            continue;
+        }
+
         auto last = bufferEnd;
 
         for (auto first = bufferBegin; first != last;)
@@ -2309,6 +2369,11 @@ void TextEditor::ColorizeInternal()
     if (mLines.empty() || !mColorizerEnabled)
         return;
 
+    // Without comment or preprocessor syntax no state carries over between lines, so the
+    // pass over the whole text is skipped and edits recolor only the lines they touched.
+    if (mCheckComments && !HasCommentSyntax())
+        mCheckComments = false;
+
     if (mCheckComments)
     {
         auto endLine = mLines.size();
@@ -2456,6 +2521,13 @@ void TextEditor::ColorizeInternal()
     }
 }
 
+bool TextEditor::HasCommentSyntax() const
+{
+    return !mLanguageDefinition.mCommentStart.empty() ||
+           !mLanguageDefinition.mSingleLineComment.empty() ||
+           mLanguageDefinition.mPreprocChar != '\0';
+}
+
 float TextEditor::TextDistanceToLineStart(const Coordinates &aFrom) const
 {
     auto &line = mLines[aFrom.mLine];
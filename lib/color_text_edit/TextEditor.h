@@ -2,6 +2,7 @@
 
 #include "imgui.h"
 #include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <regex>
@@ -159,6 +160,10 @@ class TextEditor
         typedef bool (*TokenizeCallback)(const char *in_begin, const char *in_end,
                                          const char *&out_begin, const char *&out_end,
                                          PaletteIndex &paletteIndex);
+        // Colors a whole line at once, for languages whose tokens depend on what came before
+        // them on the line. `colors` holds one entry per byte and starts out as Default.
+        typedef void (*LineTokenizeCallback)(const char *line_begin, const char *line_end,
+                                             PaletteIndex *colors);
 
         std::string mName;
         Keywords mKeywords;
@@ -169,13 +174,15 @@ class TextEditor
         bool mAutoIndentation;
 
         TokenizeCallback mTokenize;
+        LineTokenizeCallback mTokenizeLine;
 
         TokenRegexStrings mTokenRegexStrings;
 
         bool mCaseSensitive;
 
         LanguageDefinition()
-            : mPreprocChar('#'), mAutoIndentation(true), mTokenize(nullptr), mCaseSensitive(true)
+            : mPreprocChar('#'), mAutoIndentation(true), mTokenize(nullptr), mTokenizeLine(nullptr),
+              mCaseSensitive(true)
         {
         }
 
@@ -240,6 +247,11 @@ class TextEditor
     {
         return mTextChanged;
     }
+    // Bumped on every change to the text, including undo and redo.
+    uint64_t GetEditGeneration() const
+    {
+        return mEditGeneration;
+    }
     bool IsCursorPositionChanged() const
     {
         return mCursorPositionChanged;
@@ -329,6 +341,14 @@ class TextEditor
     void Undo(int aSteps = 1);
     void Redo(int aSteps = 1);
 
+    // Marks the current text as saved. IsClean() is true again whenever undo or redo steps
+    // back to it. Edits the undo history does not record (SetText, InsertText) or a dropped
+    // redo branch lose the mark; until the next MarkClean(), IsClean() stays false and
+    // HasCleanMark() tells the two cases apart.
+    void MarkClean();
+    bool IsClean() const;
+    bool HasCleanMark() const;
+
     static const Palette &GetDarkPalette();
     static const Palette &GetLightPalette();
     static const Palette &GetRetroBluePalette();
@@ -382,6 +402,7 @@ class TextEditor
     void Colorize(int aFromLine = 0, int aCount = -1);
     void ColorizeRange(int aFromLine = 0, int aToLine = 0);
     void ColorizeInternal();
+    bool HasCommentSyntax() const;
     float TextDistanceToLineStart(const Coordinates &aFrom) const;
     void EnsureCursorVisible();
     int GetPageSize() const;
@@ -428,6 +449,8 @@ class TextEditor
     bool mScrollToCursor;
     bool mScrollToTop;
     bool mTextChanged;
+    uint64_t mEditGeneration;
+    int mCleanUndoIndex; // -1 once the clean state is no longer in the undo history
     bool mColorizerEnabled;
     float mTextStart; // position (in pixels) where a code line starts relative to the left of the
                       // TextEditor.
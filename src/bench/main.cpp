@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+
+#include "core/common/version.hpp"
+#include "core/config/config.hpp"
+#include "core/io/toml_file.hpp"
+#include "core/palette/color.hpp"
+#include "core/palette/palette_file.hpp"
+#include "core/palette/palette_manager.hpp"
+#include "core/theme/theme_template.hpp"
+#include "corpus/corpus.hpp"
+
+namespace
+{
+using clock_type = std::chrono::steady_clock;
+
+// Keeps the optimizer from discarding a benchmarked result.
+template <typename T> void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+struct bench_case
+{
+    std::string name;
+    // Calls per sample; cheap operations are batched so clock overhead does not dominate.
+    size_t batch;
+    std::function<void()> run;
+};
+
+struct bench_result
+{
+    std::string name;
+    size_t samples;
+    size_t batch;
+    double median_ns;
+    double p99_ns;
+    double mean_ns;
+    double min_ns;
+};
+
+bench_result measure(const bench_case &bc, size_t samples)
+{
+    size_t warmup = std::max<size_t>(1, samples / 10);
+    for (size_t i = 0; i < warmup * bc.batch; ++i)
+        bc.run();
+
+    std::vector<double> per_call(samples);
+    for (size_t s = 0; s < samples; ++s)
+    {
+        auto start = clock_type::now();
+        for (size_t i = 0; i < bc.batch; ++i)
+            bc.run();
+        auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start);
+        per_call[s] = elapsed.count() / static_cast<double>(bc.batch);
+    }
+
+    std::sort(per_call.begin(), per_call.end());
+    double sum = 0;
+    for (double v : per_call)
+        sum += v;
+
+    auto percentile = [&per_call](double p) {
+        size_t idx = static_cast<size_t>(p * static_cast<double>(per_call.size() - 1) + 0.5);
+        return per_call[std::min(idx, per_call.size() - 1)];
+    };
+
+    return {bc.name,         samples,         bc.batch, percentile(0.5),
+            percentile(0.99), sum / samples, per_call.front()};
+}
+
+void set_home(const std::filesystem::path &home)
+{
+#ifdef _WIN32
+    _putenv_s("USERPROFILE", home.string().c_str());
+#else
+    setenv("HOME", home.c_str(), 1);
+#endif
+}
+
+std::vector<bench_case> color_cases()
+{
+    using clrsync::core::color;
+    std::vector<bench_case> cases;
+
+    auto col = std::make_shared<color>(0x3A898CFF);
+    for (const auto &spec : clrsync::corpus::FORMAT_SPECIFIERS)
+    {
+        cases.push_back({"color.format." + spec, 256, [col, spec] {
+                             do_not_optimize(col->format(spec));
+                         }});
+    }
+
+    cases.push_back({"color.from_hex_string.rgb", 256, [] {
+                         color c;
+                         c.from_hex_string("#9A8652");
+                         do_not_optimize(c);
+                     }});
+    cases.push_back({"color.from_hex_string.rgba", 256, [] {
+                         color c;
+                         c.from_hex_string("#9A8652FF");
+                         do_not_optimize(c);
+                     }});
+    cases.push_back({"color.to_hsl", 1024, [col] { do_not_optimize(col->to_hsl()); }});
+    return cases;
+}
+
+std::vector<bench_case> template_cases(const std::filesystem::path &work_dir)
+{
+    std::vector<bench_case> cases;
+    auto pal = std::make_shared<clrsync::core::palette>(
+        clrsync::corpus::make_palette("bench", 1));
+
+    const std::pair<const char *, size_t> sizes[] = {{"small", 50}, {"large", 5000}};
+    for (const auto &[label, lines] : sizes)
+    {
+        auto path = work_dir / "templates" / (std::string(label) + ".conf");
+        clrsync::corpus::template_spec spec;
+        spec.lines = lines;
+        clrsync::corpus::write_text_file(path, clrsync::corpus::make_template(spec, lines));
+
+        auto tmpl = std::make_shared<clrsync::core::theme_template>(
+            label, path.string(), (work_dir / "out" / label).string());
+        (void)tmpl->load_template();
+        cases.push_back({std::string("theme_template.apply_palette.") + label,
+                         lines < 1000 ? 16u : 1u, [tmpl, pal] {
+                             tmpl->apply_palette(*pal);
+                             do_not_optimize(tmpl->processed_template());
+                         }});
+    }
+    return cases;
+}
+
+std::vector<bench_case> palette_cases(const std::filesystem::path &work_dir, size_t count)
+{
+    using manager_type = clrsync::core::palette_manager<clrsync::core::io::toml_file>;
+    std::vector<bench_case> cases;
+
+    auto dir = work_dir / "palettes";
+    clrsync::corpus::write_palettes(dir, count, 7);
+    auto single = (dir / "palette-0.toml").string();
+
+    cases.push_back({"palette_file.parse", 4, [single] {
+                         clrsync::core::palette_file<clrsync::core::io::toml_file> file(single);
+                         do_not_optimize(file.parse());
+                     }});
+
+    const std::string suffix = "." + std::to_string(count);
+    cases.push_back({"palette_manager.load_palettes_from_directory.cold" + suffix, 1,
+                     [dir] {
+                         manager_type manager;
+                         manager.load_palettes_from_directory(dir.string());
+                         do_not_optimize(manager.palettes().size());
+                     }});
+
+    auto warm = std::make_shared<manager_type>();
+    warm->load_palettes_from_directory(dir.string());
+    cases.push_back({"palette_manager.load_palettes_from_directory.warm" + suffix, 1,
+                     [warm, dir] {
+                         warm->load_palettes_from_directory(dir.string());
+                         do_not_optimize(warm->palettes().size());
+                     }});
+    return cases;
+}
+
+std::vector<bench_case> config_cases(const std::filesystem::path &work_dir)
+{
+    // config seeds and resolves everything relative to the home directory.
+    set_home(work_dir);
+
+    clrsync::corpus::corpus_spec spec;
+    spec.templates = 8;
+    auto config_path = clrsync::corpus::write_corpus(work_dir / "corpus", spec);
+
+    return {{"config.initialize", 1, [config_path] {
+                 auto file = std::make_unique<clrsync::core::io::toml_file>(config_path.string());
+                 do_not_optimize(
+                     clrsync::core::config::instance().initialize(std::move(file)).is_ok());
+             }}};
+}
+
+// Cost against input size, for plotting: cold directory scans over growing palette counts
+// and renders of growing templates.
+std::vector<bench_case> scaling_cases(const std::filesystem::path &work_dir)
+{
+    using manager_type = clrsync::core::palette_manager<clrsync::core::io::toml_file>;
+    std::vector<bench_case> cases;
+
+    for (size_t count : {16, 64, 256, 1024, 4096})
+    {
+        auto dir = work_dir / "scaling" / ("palettes-" + std::to_string(count));
+        clrsync::corpus::write_palettes(dir, count, 11);
+        cases.push_back({"scaling.palettes." + std::to_string(count), 1, [dir] {
+                             manager_type manager;
+                             manager.load_palettes_from_directory(dir.string());
+                             do_not_optimize(manager.palettes().size());
+                         }});
+    }
+
+    auto pal = std::make_shared<clrsync::core::palette>(
+        clrsync::corpus::make_palette("scaling", 3));
+    for (size_t lines : {100, 1000, 10000, 100000})
+    {
+        auto path = work_dir / "scaling" / ("template-" + std::to_string(lines) + ".conf");
+        clrsync::corpus::template_spec spec;
+        spec.lines = lines;
+        spec.density = 1.0;
+        clrsync::corpus::write_text_file(path, clrsync::corpus::make_template(spec, lines));
+
+        auto tmpl = std::make_shared<clrsync::core::theme_template>("scaling", path.string(),
+                                                                   path.string() + ".out");
+        (void)tmpl->load_template();
+        cases.push_back({"scaling.template_lines." + std::to_string(lines), 1, [tmpl, pal] {
+                             tmpl->apply_palette(*pal);
+                             do_not_optimize(tmpl->processed_template());
+                         }});
+    }
+    return cases;
+}
+
+void print_text(const std::vector<bench_result> &results)
+{
+    std::printf("%-58s %12s %12s %12s\n", "benchmark", "median", "p99", "min");
+    for (const auto &r : results)
+    {
+        auto fmt = [](double ns) {
+            char buffer[32];
+            if (ns >= 1e6)
+                std::snprintf(buffer, sizeof(buffer), "%.3f ms", ns / 1e6);
+            else if (ns >= 1e3)
+                std::snprintf(buffer, sizeof(buffer), "%.3f us", ns / 1e3);
+            else
+                std::snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+            return std::string(buffer);
+        };
+        std::printf("%-58s %12s %12s %12s\n", r.name.c_str(), fmt(r.median_ns).c_str(),
+                    fmt(r.p99_ns).c_str(), fmt(r.min_ns).c_str());
+    }
+}
+
+void print_json(const std::vector<bench_result> &results)
+{
+    std::printf("{\"version\":\"%s\",\"results\":[", clrsync::core::version_string().c_str());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &r = results[i];
+        std::printf("%s{\"name\":\"%s\",\"samples\":%zu,\"batch\":%zu,\"median_ns\":%.1f,"
+                    "\"p99_ns\":%.1f,\"mean_ns\":%.1f,\"min_ns\":%.1f}",
+                    i ? "," : "", r.name.c_str(), r.samples, r.batch, r.median_ns, r.p99_ns,
+                    r.mean_ns, r.min_ns);
+    }
+    std::printf("]}\n");
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("clrsync_bench", clrsync::core::version_string());
+    program.add_argument("--json").help("prints results as JSON").flag();
+    program.add_argument("--filter")
+        .default_value(std::string{})
+        .help("runs only benchmarks whose name contains this text")
+        .metavar("TEXT");
+    program.add_argument("--samples")
+        .default_value(200)
+        .scan<'i', int>()
+        .help("timed samples per benchmark, after a 10% warmup")
+        .metavar("N");
+    program.add_argument("--scaling")
+        .help("also runs the scaling series over palette count and template size")
+        .flag();
+    program.add_argument("--palettes")
+        .default_value(64)
+        .scan<'i', int>()
+        .help("palette files for the directory scan benchmarks")
+        .metavar("N");
+
+    try
+    {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::exception &err)
+    {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        return 1;
+    }
+
+    const auto samples = static_cast<size_t>(std::max(1, program.get<int>("--samples")));
+    const auto palettes = static_cast<size_t>(std::max(1, program.get<int>("--palettes")));
+    const auto filter = program.get<std::string>("--filter");
+
+    auto work_dir = std::filesystem::temp_directory_path() /
+                    ("clrsync-bench-" + std::to_string(clock_type::now().time_since_epoch().count()));
+    std::filesystem::create_directories(work_dir);
+
+    std::vector<bench_case> cases = color_cases();
+    for (auto &group : {template_cases(work_dir), palette_cases(work_dir, palettes),
+                        config_cases(work_dir)})
+        cases.insert(cases.end(), group.begin(), group.end());
+    if (program.get<bool>("--scaling"))
+    {
+        auto group = scaling_cases(work_dir);
+        cases.insert(cases.end(), group.begin(), group.end());
+    }
+
+    std::vector<bench_result> results;
+    for (const auto &bc : cases)
+    {
+        if (!filter.empty() && bc.name.find(filter) == std::string::npos)
+            continue;
+        results.push_back(measure(bc, samples));
+    }
+
+    clrsync::core::config::instance().stop_watching();
+    std::error_code ec;
+    std::filesystem::remove_all(work_dir, ec);
+
+    if (program.get<bool>("--json"))
+        print_json(results);
+    else
+        print_text(results);
+    return 0;
+}
@@ -0,0 +1,432 @@
+#include "cli/daemon.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include "core/common/utils.hpp"
+#include "core/config/config.hpp"
+#include "core/io/file_watcher.hpp"
+#include "core/io/toml_file.hpp"
+#include "core/theme/template_filter.hpp"
+#include "core/theme/theme_renderer.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+namespace clrsync::cli
+{
+std::filesystem::path daemon_socket_path(const std::string &config_path)
+{
+    char name[40];
+    std::snprintf(name, sizeof(name), "clrsync-%016llx.sock",
+                  static_cast<unsigned long long>(
+                      core::fnv1a64(core::normalize_path(config_path).string())));
+
+    const char *runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && runtime_dir[0] != '\0')
+        return std::filesystem::path(runtime_dir) / name;
+    return core::config::instance().get_user_state_dir() / name;
+}
+
+#ifdef __linux__
+
+namespace
+{
+using renderer_type = core::theme_renderer<core::io::toml_file>;
+using clock = std::chrono::steady_clock;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void on_signal(int)
+{
+    g_stop = 1;
+}
+
+bool make_address(const std::filesystem::path &path, sockaddr_un &addr)
+{
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    const std::string str = path.string();
+    if (str.size() >= sizeof(addr.sun_path))
+        return false;
+    std::memcpy(addr.sun_path, str.c_str(), str.size() + 1);
+    return true;
+}
+
+bool write_all(int fd, const std::string &data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Undoes the client's encoding of option lists: "%20" is a space and "%25" a '%'.
+std::string decode_list(const std::string &list)
+{
+    std::string decoded;
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        if (list.compare(i, 3, "%20") == 0)
+        {
+            decoded += ' ';
+            i += 2;
+        }
+        else if (list.compare(i, 3, "%25") == 0)
+        {
+            decoded += '%';
+            i += 2;
+        }
+        else
+        {
+            decoded += list[i];
+        }
+    }
+    return decoded;
+}
+
+std::string read_line(int fd)
+{
+    std::string line;
+    char buffer[512];
+    while (line.find('\n') == std::string::npos && line.size() < 4096)
+    {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        line.append(buffer, static_cast<size_t>(n));
+    }
+    auto end = line.find('\n');
+    if (end != std::string::npos)
+        line.resize(end);
+    return line;
+}
+
+class daemon_server
+{
+  public:
+    daemon_server(std::string config_path, std::chrono::milliseconds debounce)
+        : m_config_path(std::move(config_path)), m_debounce(debounce)
+    {
+    }
+
+    ~daemon_server()
+    {
+        if (m_listen_fd >= 0)
+        {
+            close(m_listen_fd);
+            std::filesystem::remove(m_socket_path);
+        }
+        if (m_epoll_fd >= 0)
+            close(m_epoll_fd);
+    }
+
+    int run()
+    {
+        if (!reload())
+            return 1;
+        if (!listen_socket())
+            return 1;
+
+        m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = m_listen_fd;
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_listen_fd, &ev);
+        ev.data.fd = m_watcher.native_handle();
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_watcher.native_handle(), &ev);
+
+        std::cout << "clrsync daemon listening on " << m_socket_path.string() << std::endl;
+
+        while (!g_stop)
+        {
+            epoll_event events[2];
+            int n = epoll_wait(m_epoll_fd, events, 2, -1);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+            {
+                std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+                return 1;
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                if (events[i].data.fd == m_listen_fd)
+                    serve_client();
+                else
+                    handle_changes();
+            }
+        }
+        return 0;
+    }
+
+  private:
+    std::string m_config_path;
+    std::chrono::milliseconds m_debounce;
+    std::filesystem::path m_socket_path;
+    int m_listen_fd{-1};
+    int m_epoll_fd{-1};
+    core::io::file_watcher m_watcher;
+    std::unique_ptr<renderer_type> m_renderer;
+
+    bool listen_socket()
+    {
+        m_socket_path = daemon_socket_path(m_config_path);
+        std::error_code ec;
+        std::filesystem::create_directories(m_socket_path.parent_path(), ec);
+
+        sockaddr_un addr;
+        if (!make_address(m_socket_path, addr))
+        {
+            std::cerr << "Socket path is too long: " << m_socket_path << std::endl;
+            return false;
+        }
+
+        if (daemon_request(m_config_path, "ping"))
+        {
+            std::cerr << "A daemon is already running on " << m_socket_path << std::endl;
+            return false;
+        }
+        std::filesystem::remove(m_socket_path, ec);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            listen(fd, 16) != 0)
+        {
+            std::cerr << "Failed to listen on " << m_socket_path << ": " << std::strerror(errno)
+                      << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return false;
+        }
+        m_listen_fd = fd;
+        return true;
+    }
+
+    bool reload()
+    {
+        auto conf = std::make_unique<core::io::toml_file>(m_config_path);
+        auto result = core::config::instance().initialize(std::move(conf));
+        if (!result)
+        {
+            std::cerr << "Error loading config: " << result.error().description() << std::endl;
+            return false;
+        }
+
+        m_renderer = std::make_unique<renderer_type>();
+        m_renderer->preload_templates();
+
+        auto &cfg = core::config::instance();
+        m_watcher.clear();
+        (void)m_watcher.add_file(m_config_path);
+        (void)m_watcher.add_directory(cfg.palettes_path());
+        for (const auto &[name, tmpl] : cfg.templates())
+        {
+            if (tmpl.enabled())
+                (void)m_watcher.add_file(tmpl.template_path());
+        }
+        refresh_bundles();
+        return true;
+    }
+
+    // Re-renders bundle outputs made stale by a palette or template change, so a later
+    // switch to any palette stays a single rename.
+    void refresh_bundles()
+    {
+        core::Result<size_t> result = core::Ok<size_t>(0);
+        try
+        {
+            result = m_renderer->build_bundles();
+        }
+        catch (const std::exception &e)
+        {
+            result = core::Err<size_t>(core::error_code::template_apply_failed, e.what());
+        }
+        if (!result)
+            std::cerr << "Failed to build bundles: " << result.error().description() << std::endl;
+    }
+
+    void handle_changes()
+    {
+        auto batch = m_watcher.wait(m_debounce, std::chrono::milliseconds(0));
+        if (!batch || batch.value().paths.empty())
+            return;
+
+        const auto config_path = core::normalize_path(m_config_path);
+        const auto palettes_dir = core::normalize_path(core::config::instance().palettes_path());
+        bool palettes_changed = false;
+        for (const auto &path : batch.value().paths)
+        {
+            if (path == config_path)
+            {
+                if (!reload())
+                    std::cerr << "Keeping previous config" << std::endl;
+                return;
+            }
+            if (path.parent_path() == palettes_dir)
+                palettes_changed = true;
+        }
+
+        if (palettes_changed)
+            m_renderer->reload_palettes();
+        m_renderer->preload_templates();
+        refresh_bundles();
+    }
+
+    void serve_client()
+    {
+        int fd = accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        timeval timeout{1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        auto reply = handle_request(read_line(fd));
+        (void)write_all(fd, (reply.ok ? "ok " : "err ") + reply.message + "\n");
+        close(fd);
+    }
+
+    daemon_reply handle_request(const std::string &line)
+    {
+        auto space = line.find(' ');
+        std::string command = line.substr(0, space);
+        std::string arg = space == std::string::npos ? std::string{} : line.substr(space + 1);
+
+        if (command == "ping")
+            return {true, "pong"};
+
+        if (command != "apply" && command != "apply-path")
+            return {false, "Unknown request: " + command};
+
+        std::string only;
+        std::string except;
+        while (arg.rfind("only=", 0) == 0 || arg.rfind("except=", 0) == 0)
+        {
+            size_t end = std::min(arg.find(' '), arg.size());
+            size_t eq = arg.find('=');
+            (arg[0] == 'o' ? only : except) = decode_list(arg.substr(eq + 1, end - eq - 1));
+            arg = end < arg.size() ? arg.substr(end + 1) : std::string{};
+        }
+        auto filter = core::template_filter::from_lists(only, except);
+
+        if (command == "apply" && arg.empty())
+            arg = core::config::instance().default_theme();
+        if (arg.empty())
+            return {false, "Default theme is not set or missing."};
+
+        auto start = clock::now();
+        core::Result<void> result = core::Ok();
+        try
+        {
+            result = command == "apply" ? m_renderer->apply_theme(arg, filter)
+                                        : m_renderer->apply_theme_from_path(arg, filter);
+        }
+        catch (const std::exception &e)
+        {
+            result = core::Err<void>(core::error_code::template_apply_failed, e.what());
+        }
+
+        if (!result)
+            return {false, result.error().description()};
+
+        double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        char message[64];
+        std::snprintf(message, sizeof(message), " in %.3f ms", ms);
+        return {true, "Applied theme " + arg + message};
+    }
+};
+} // namespace
+
+int run_daemon(const std::string &config_path, std::chrono::milliseconds debounce)
+{
+    struct sigaction action{};
+    action.sa_handler = on_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    daemon_server server(config_path, debounce);
+    return server.run();
+}
+
+std::optional<daemon_reply> daemon_request(const std::string &config_path,
+                                           const std::string &request)
+{
+    sockaddr_un addr;
+    if (!make_address(daemon_socket_path(config_path), addr))
+        return std::nullopt;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return std::nullopt;
+
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        !write_all(fd, request + "\n"))
+    {
+        close(fd);
+        return std::nullopt;
+    }
+
+    // An apply runs reload commands, so allow it far longer than the server allows a client.
+    timeval timeout{10, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string line = read_line(fd);
+    close(fd);
+
+    // The daemon died or stalled before answering.
+    if (line.empty())
+        return std::nullopt;
+
+    daemon_reply reply;
+    if (line.rfind("ok ", 0) == 0)
+    {
+        reply.ok = true;
+        reply.message = line.substr(3);
+    }
+    else
+    {
+        reply.message = line.rfind("err ", 0) == 0 ? line.substr(4) : "Malformed daemon reply";
+    }
+    return reply;
+}
+
+#else
+
+int run_daemon(const std::string &, std::chrono::milliseconds)
+{
+    std::cerr << "Daemon mode is not supported on this platform" << std::endl;
+    return 1;
+}
+
+std::optional<daemon_reply> daemon_request(const std::string &, const std::string &)
+{
+    return std::nullopt;
+}
+
+#endif
+} // namespace clrsync::cli
@@ -0,0 +1,39 @@
+#ifndef CLRSYNC_CLI_DAEMON_HPP
+#define CLRSYNC_CLI_DAEMON_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+// The daemon keeps config, parsed palettes and tokenized templates resident and serves a
+// line protocol on a Unix domain socket, one request per connection:
+//
+//   apply [<options>] [<theme>]     apply a palette by name (default_theme when omitted)
+//   apply-path [<options>] <file>   apply a palette file
+//   ping
+//
+// where <options> are "only=<list>" and "except=<list>" with comma-separated template names
+// or tags, spaces encoded as "%20" and '%' as "%25".
+//
+// Every request is answered with a single "ok <message>" or "err <message>" line.
+namespace clrsync::cli
+{
+struct daemon_reply
+{
+    bool ok{false};
+    std::string message;
+};
+
+// One socket per config file, so daemons for different configs do not collide.
+std::filesystem::path daemon_socket_path(const std::string &config_path);
+
+int run_daemon(const std::string &config_path, std::chrono::milliseconds debounce);
+
+// Returns std::nullopt when no daemon is listening for this config, or when it did not answer
+// within 10 seconds.
+std::optional<daemon_reply> daemon_request(const std::string &config_path,
+                                           const std::string &request);
+} // namespace clrsync::cli
+
+#endif // CLRSYNC_CLI_DAEMON_HPP
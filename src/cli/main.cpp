@@ -4,13 +4,18 @@
 
 #include <argparse/argparse.hpp>
 
+#include "cli/daemon.hpp"
+#include "cli/watch.hpp"
+
 #include "core/common/error.hpp"
+#include "core/common/trace.hpp"
 #include "core/common/utils.hpp"
 #include "core/common/version.hpp"
 #include "core/config/config.hpp"
 #include "core/io/toml_file.hpp"
 #include "core/palette/palette_file.hpp"
 #include "core/palette/palette_manager.hpp"
+#include "core/theme/template_filter.hpp"
 #include "core/theme/theme_renderer.hpp"
 #include "core/theme/theme_template.hpp"
 
@@ -32,8 +37,17 @@ void handle_list_themes()
     }
 }
 
+clrsync::core::template_filter template_filter_from(const argparse::ArgumentParser &program)
+{
+    return clrsync::core::template_filter::from_lists(
+        program.is_used("--only") ? program.get<std::string>("--only") : std::string{},
+        program.is_used("--except") ? program.get<std::string>("--except") : std::string{});
+}
+
 int handle_apply_theme(const argparse::ArgumentParser &program, const std::string &default_theme)
 {
+    clrsync::core::trace::scope apply_scope("cli.apply");
+    const auto filter = template_filter_from(program);
     clrsync::core::theme_renderer<clrsync::core::io::toml_file> renderer;
     std::string theme_identifier;
     clrsync::core::Result<void> result = clrsync::core::Ok();
@@ -41,12 +55,12 @@ int handle_apply_theme(const argparse::ArgumentParser &program, const std::strin
     if (program.is_used("--theme"))
     {
         theme_identifier = program.get<std::string>("--theme");
-        result = renderer.apply_theme(theme_identifier);
+        result = renderer.apply_theme(theme_identifier, filter);
     }
     else if (program.is_used("--path"))
     {
         theme_identifier = program.get<std::string>("--path");
-        result = renderer.apply_theme_from_path(theme_identifier);
+        result = renderer.apply_theme_from_path(theme_identifier, filter);
     }
     else
     {
@@ -56,7 +70,7 @@ int handle_apply_theme(const argparse::ArgumentParser &program, const std::strin
             return 1;
         }
         theme_identifier = default_theme;
-        result = renderer.apply_theme(theme_identifier);
+        result = renderer.apply_theme(theme_identifier, filter);
     }
 
     if (!result)
@@ -69,6 +83,95 @@ int handle_apply_theme(const argparse::ArgumentParser &program, const std::strin
     return 0;
 }
 
+int handle_build_bundles()
+{
+    if (!clrsync::core::config::instance().snapshot()->bundles)
+    {
+        std::cerr << "Bundles are disabled; set bundles = true under [general]" << std::endl;
+        return 1;
+    }
+
+    clrsync::core::theme_renderer<clrsync::core::io::toml_file> renderer;
+    auto result = renderer.build_bundles();
+    if (!result)
+    {
+        std::cerr << "Failed to build bundles: " << result.error().description() << std::endl;
+        return 1;
+    }
+    std::cout << "Rendered " << result.value() << " bundle outputs" << std::endl;
+    return 0;
+}
+
+// Hands an --apply request to a running daemon. Returns -1 when no daemon answered, so the
+// caller falls back to applying in-process.
+int try_daemon_apply(const argparse::ArgumentParser &program, const std::string &config_path)
+{
+    // Requests are space-separated, so spaces in a list (and '%') travel percent-encoded.
+    auto list_option = [&program](const std::string &name) {
+        std::string encoded;
+        for (char c : program.get<std::string>("--" + name))
+        {
+            if (c == ' ')
+                encoded += "%20";
+            else if (c == '%')
+                encoded += "%25";
+            else
+                encoded += c;
+        }
+        return " " + name + "=" + encoded;
+    };
+
+    std::string request = program.is_used("--path") ? "apply-path" : "apply";
+    if (program.is_used("--only"))
+        request += list_option("only");
+    if (program.is_used("--except"))
+        request += list_option("except");
+    if (program.is_used("--theme"))
+        request += " " + program.get<std::string>("--theme");
+    else if (program.is_used("--path"))
+        request += " " + clrsync::core::normalize_path(program.get<std::string>("--path")).string();
+
+    auto reply = clrsync::cli::daemon_request(config_path, request);
+    if (!reply)
+        return -1;
+
+    if (!reply->ok)
+    {
+        std::cerr << "Failed to apply theme: " << reply->message << std::endl;
+        return 1;
+    }
+    std::cout << reply->message << std::endl;
+    return 0;
+}
+
+void print_timings(const std::string &format)
+{
+    auto events = clrsync::core::trace::take();
+    auto counters = clrsync::core::trace::take_counters();
+    if (format == "json")
+    {
+        clrsync::core::trace::write_json(std::cout, events, counters);
+        return;
+    }
+    std::cout << "Timings:" << std::endl;
+    clrsync::core::trace::write_text(std::cout, events, counters);
+
+    int64_t hits = 0;
+    int64_t misses = 0;
+    for (const auto &c : counters)
+    {
+        if (std::string_view(c.name) == "render_cache.hits")
+            hits = c.value;
+        else if (std::string_view(c.name) == "render_cache.misses")
+            misses = c.value;
+    }
+    if (hits + misses > 0)
+    {
+        std::cout << "Render cache hit rate: " << (100 * hits / (hits + misses)) << "% (" << hits
+                  << "/" << hits + misses << ")" << std::endl;
+    }
+}
+
 clrsync::core::Result<void> initialize_config(const std::string &config_path)
 {
     auto conf = std::make_unique<clrsync::core::io::toml_file>(config_path);
@@ -88,6 +191,42 @@ void setup_argument_parser(argparse::ArgumentParser &program)
 
     program.add_argument("-s", "--show-vars").help("shows color keys").flag();
 
+    program.add_argument("-w", "--watch")
+        .help("re-applies the theme whenever palettes, templates or the config change")
+        .flag();
+
+    program.add_argument("--debounce")
+        .default_value(3)
+        .scan<'i', int>()
+        .help("milliseconds without further changes before a save burst is applied")
+        .metavar("MS");
+
+    program.add_argument("--only")
+        .help("applies only the templates with these comma-separated names or tags")
+        .metavar("LIST");
+
+    program.add_argument("--except")
+        .help("skips the templates with these comma-separated names or tags")
+        .metavar("LIST");
+
+    program.add_argument("--timings")
+        .default_value(std::string{})
+        .nargs(argparse::nargs_pattern::optional)
+        .help("prints how long each apply stage took; --timings=json for machine-readable output")
+        .metavar("FORMAT");
+
+    program.add_argument("--build-bundles")
+        .help("pre-renders the palette bundles that are out of date (needs bundles = true)")
+        .flag();
+
+    program.add_argument("-d", "--daemon")
+        .help("keeps config, palettes and templates resident and serves --apply requests")
+        .flag();
+
+    program.add_argument("--no-daemon")
+        .help("applies in-process even if a daemon is running")
+        .flag();
+
     auto &group = program.add_mutually_exclusive_group();
     group.add_argument("-t", "--theme").help("sets theme <theme_name> to apply");
     group.add_argument("-p", "--path").help("sets theme file <path/to/theme> to apply");
@@ -111,6 +250,43 @@ int main(int argc, char *argv[])
 
     std::string config_path = program.get<std::string>("--config");
 
+    std::string timings;
+    if (program.is_used("--timings"))
+    {
+        timings = program.get<std::string>("--timings");
+        if (timings.empty())
+            timings = "text";
+        if (timings != "text" && timings != "json")
+        {
+            std::cerr << "Unknown timings format: " << timings << " (expected text or json)"
+                      << std::endl;
+            return 1;
+        }
+        clrsync::core::trace::enable(true);
+    }
+
+    if (program.get<int>("--debounce") < 0)
+    {
+        std::cerr << "Invalid debounce: " << program.get<int>("--debounce")
+                  << " (expected 0 or more milliseconds)" << std::endl;
+        return 1;
+    }
+
+    // A daemon's stages cannot be timed from here, so --timings always applies in-process.
+    if (program.is_used("--apply") && !program.is_used("--watch") &&
+        !program.is_used("--no-daemon") && !program.is_used("--build-bundles") && timings.empty())
+    {
+        int daemon_result = try_daemon_apply(program, config_path);
+        if (daemon_result >= 0)
+            return daemon_result;
+    }
+
+    if (program.is_used("--daemon"))
+    {
+        return clrsync::cli::run_daemon(config_path,
+                                        std::chrono::milliseconds(program.get<int>("--debounce")));
+    }
+
     auto config_result = initialize_config(config_path);
     if (!config_result)
     {
@@ -130,10 +306,38 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (program.is_used("--build-bundles"))
+    {
+        int result = handle_build_bundles();
+        if (result != 0 || !program.is_used("--apply"))
+            return result;
+    }
+
+    if (program.is_used("--watch"))
+    {
+        clrsync::cli::watch_options options;
+        options.config_path = config_path;
+        options.debounce = std::chrono::milliseconds(program.get<int>("--debounce"));
+        options.filter = template_filter_from(program);
+        if (program.is_used("--theme"))
+        {
+            options.theme = program.get<std::string>("--theme");
+        }
+        else if (program.is_used("--path"))
+        {
+            options.theme = program.get<std::string>("--path");
+            options.theme_is_path = true;
+        }
+        return clrsync::cli::run_watch(options);
+    }
+
     if (program.is_used("--apply"))
     {
         const std::string default_theme = clrsync::core::config::instance().default_theme();
-        return handle_apply_theme(program, default_theme);
+        int result = handle_apply_theme(program, default_theme);
+        if (!timings.empty())
+            print_timings(timings);
+        return result;
     }
 
     std::cout << program << std::endl;
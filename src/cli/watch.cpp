@@ -0,0 +1,277 @@
+#include "cli/watch.hpp"
+
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/common/utils.hpp"
+#include "core/config/config.hpp"
+#include "core/io/file_watcher.hpp"
+#include "core/io/toml_file.hpp"
+#include "core/palette/palette_manager.hpp"
+#include "core/theme/theme_renderer.hpp"
+
+namespace clrsync::cli
+{
+namespace
+{
+using renderer_type = core::theme_renderer<core::io::toml_file>;
+using clock = std::chrono::steady_clock;
+
+double elapsed_ms(clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(clock::now() - since).count();
+}
+
+class watch_session
+{
+  public:
+    explicit watch_session(const watch_options &options) : m_options(options)
+    {
+    }
+
+    int run()
+    {
+        if (!reload_all())
+            return 1;
+
+        std::cout << "Watching for changes (Ctrl+C to stop)..." << std::endl;
+        for (;;)
+        {
+            auto batch = m_watcher.wait(m_options.debounce);
+            if (!batch)
+            {
+                std::cerr << "Watch failed: " << batch.error().description() << std::endl;
+                return 1;
+            }
+            if (!batch.value().paths.empty())
+                handle(batch.value());
+        }
+    }
+
+  private:
+    const watch_options &m_options;
+    core::io::file_watcher m_watcher;
+    std::unique_ptr<renderer_type> m_renderer;
+    std::filesystem::path m_config_path;
+    std::filesystem::path m_palettes_dir;
+    std::unordered_map<std::string, std::string> m_template_inputs;
+    std::optional<core::palette> m_palette;
+
+    std::string theme_name() const
+    {
+        if (!m_options.theme.empty())
+            return m_options.theme;
+        return core::config::instance().default_theme();
+    }
+
+    std::optional<core::palette> resolve_palette()
+    {
+        if (m_options.theme_is_path)
+        {
+            auto pal = core::palette_manager<core::io::toml_file>().load_palette_from_file(
+                core::normalize_path(m_options.theme).string());
+            if (pal.colors().empty())
+                return std::nullopt;
+            return pal;
+        }
+
+        const auto *pal = m_renderer->get_palette(theme_name());
+        if (!pal)
+            return std::nullopt;
+        return *pal;
+    }
+
+    bool register_watches()
+    {
+        m_watcher.clear();
+        m_template_inputs.clear();
+
+        m_config_path = core::normalize_path(m_options.config_path);
+        m_palettes_dir = core::normalize_path(core::config::instance().palettes_path());
+
+        bool ok = true;
+        auto add = [&ok](const core::Result<void> &result, const std::string &what) {
+            if (!result)
+            {
+                std::cerr << "Cannot watch " << what << ": " << result.error().description()
+                          << std::endl;
+                ok = false;
+            }
+        };
+
+        add(m_watcher.add_file(m_config_path), "config");
+        if (m_options.theme_is_path)
+            add(m_watcher.add_file(m_options.theme), "palette");
+        else
+            add(m_watcher.add_directory(m_palettes_dir), "palettes directory");
+
+        for (const auto &[name, tmpl] : core::config::instance().templates())
+        {
+            if (!tmpl.enabled() || !m_options.filter.matches(tmpl))
+                continue;
+            m_template_inputs[tmpl.template_path()] = name;
+            add(m_watcher.add_file(tmpl.template_path()), "template " + name);
+        }
+        return ok;
+    }
+
+    bool reload_all()
+    {
+        auto conf = std::make_unique<core::io::toml_file>(m_options.config_path);
+        auto init_result = core::config::instance().initialize(std::move(conf));
+        if (!init_result)
+        {
+            std::cerr << "Error loading config: " << init_result.error().description()
+                      << std::endl;
+            return false;
+        }
+
+        m_renderer = std::make_unique<renderer_type>();
+        if (!register_watches())
+            return false;
+
+        m_palette = resolve_palette();
+        if (!m_palette)
+        {
+            std::cerr << "Palette not found: " << m_options.theme << std::endl;
+            return true;
+        }
+        bool applied = apply_all();
+        refresh_bundles();
+        return applied;
+    }
+
+    bool apply_all()
+    {
+        auto start = clock::now();
+        auto result = guarded([&] {
+            return m_renderer->apply_palette_to_all_templates(*m_palette, m_options.filter);
+        });
+        if (!result)
+        {
+            std::cerr << "Failed to apply theme: " << result.error().description() << std::endl;
+            return false;
+        }
+        std::cout << "Applied theme " << m_palette->name() << " in " << std::fixed
+                  << std::setprecision(3) << elapsed_ms(start) << " ms" << std::endl;
+        return true;
+    }
+
+    // The active bundle is updated by the apply itself; this catches up the others so
+    // switching to them stays a single rename.
+    void refresh_bundles()
+    {
+        auto result = guarded([&] { return m_renderer->build_bundles(); });
+        if (!result)
+            std::cerr << "Failed to build bundles: " << result.error().description() << std::endl;
+        else if (result.value() > 0)
+            std::cout << "Rebuilt " << result.value() << " bundle outputs" << std::endl;
+    }
+
+    template <typename F> static auto guarded(F &&apply) -> decltype(apply())
+    {
+        try
+        {
+            return apply();
+        }
+        catch (const std::exception &e)
+        {
+            return core::Error(core::error_code::template_apply_failed, e.what());
+        }
+    }
+
+    void handle(const core::io::watch_batch &batch)
+    {
+        bool config_changed = false;
+        bool palette_changed = false;
+        std::unordered_set<std::string> templates;
+
+        for (const auto &path : batch.paths)
+        {
+            if (path == m_config_path)
+                config_changed = true;
+            else if (m_options.theme_is_path ? path == core::normalize_path(m_options.theme)
+                                             : path.parent_path() == m_palettes_dir)
+                palette_changed = true;
+
+            auto it = m_template_inputs.find(path.string());
+            if (it != m_template_inputs.end())
+                templates.insert(it->second);
+        }
+
+        // `what` names the inputs that reached their outputs; whole-set failures are reported
+        // where they happen and leave it empty.
+        std::string what;
+        bool ok = true;
+        if (config_changed)
+        {
+            if (reload_all())
+                what = "config";
+            else
+                std::cerr << "Failed to update config" << std::endl;
+        }
+        else
+        {
+            if (palette_changed)
+            {
+                if (!m_options.theme_is_path)
+                    m_renderer->reload_palettes();
+
+                auto pal = resolve_palette();
+                bool affected = pal.has_value() != m_palette.has_value() ||
+                                (pal && (pal->file_path() != m_palette->file_path() ||
+                                         pal->colors() != m_palette->colors()));
+                m_palette = std::move(pal);
+                if (affected && m_palette)
+                {
+                    if (apply_all())
+                        what = "palette " + m_palette->name();
+                    else
+                        std::cerr << "Failed to update palette " << m_palette->name() << std::endl;
+                    templates.clear();
+                }
+            }
+
+            if (m_palette)
+            {
+                for (const auto &name : templates)
+                {
+                    auto result = guarded(
+                        [&] { return m_renderer->apply_palette_to_template(*m_palette, name); });
+                    if (!result)
+                    {
+                        std::cerr << "Failed to render " << name << ": "
+                                  << result.error().description() << std::endl;
+                        ok = false;
+                        continue;
+                    }
+                    what += (what.empty() ? "template " : ", ") + name;
+                }
+            }
+        }
+
+        if (!what.empty())
+        {
+            std::cout << (ok ? "Updated " : "Partially updated ") << what << ": " << std::fixed
+                      << std::setprecision(3) << elapsed_ms(batch.first_event)
+                      << " ms from change to output (debounce " << m_options.debounce.count()
+                      << " ms)" << std::endl;
+        }
+        // Changes to palettes other than the active one only matter to their bundles.
+        if (!config_changed)
+            refresh_bundles();
+    }
+};
+} // namespace
+
+int run_watch(const watch_options &options)
+{
+    watch_session session(options);
+    return session.run();
+}
+} // namespace clrsync::cli
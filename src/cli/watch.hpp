@@ -0,0 +1,27 @@
+#ifndef CLRSYNC_CLI_WATCH_HPP
+#define CLRSYNC_CLI_WATCH_HPP
+
+#include <chrono>
+#include <string>
+
+#include "core/theme/template_filter.hpp"
+
+namespace clrsync::cli
+{
+struct watch_options
+{
+    std::string config_path;
+    // Palette name, or a palette file when `theme_is_path` is set; empty means default_theme.
+    std::string theme;
+    bool theme_is_path{false};
+    // Templates outside the filter are neither watched nor rendered.
+    core::template_filter filter{};
+    std::chrono::milliseconds debounce{3};
+};
+
+// Applies the theme once, then re-renders whatever a palette, template or config change
+// affects until interrupted.
+int run_watch(const watch_options &options);
+} // namespace clrsync::cli
+
+#endif // CLRSYNC_CLI_WATCH_HPP
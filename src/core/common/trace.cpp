@@ -0,0 +1,173 @@
+#include "core/common/trace.hpp"
+#include "core/common/version.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <mutex>
+
+namespace clrsync::core::trace
+{
+namespace detail
+{
+std::atomic<bool> g_enabled{false};
+}
+
+namespace
+{
+std::mutex g_mutex;
+std::vector<event> g_events;
+std::map<std::string_view, int64_t> g_counters;
+std::chrono::steady_clock::time_point g_epoch;
+thread_local int t_depth = 0;
+
+double to_ms(std::chrono::nanoseconds ns)
+{
+    return std::chrono::duration<double, std::milli>(ns).count();
+}
+
+void write_json_string(std::ostream &out, std::string_view str)
+{
+    out << '"';
+    for (char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                out << buffer;
+            }
+            else
+            {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+} // namespace
+
+void enable(bool on)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (on)
+    {
+        g_events.clear();
+        g_counters.clear();
+        g_epoch = std::chrono::steady_clock::now();
+    }
+    detail::g_enabled.store(on, std::memory_order_relaxed);
+}
+
+std::vector<event> take()
+{
+    std::vector<event> events;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        events.swap(g_events);
+    }
+    // Scopes record on exit, so inner stages arrive before the stage that contains them.
+    std::stable_sort(events.begin(), events.end(),
+                     [](const event &a, const event &b) { return a.start < b.start; });
+    return events;
+}
+
+void detail::add(const char *name, int64_t delta)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_counters[name] += delta;
+}
+
+std::vector<counter> take_counters()
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    std::vector<counter> counters;
+    for (const auto &[name, value] : g_counters)
+        counters.push_back({name.data(), value});
+    g_counters.clear();
+    return counters;
+}
+
+void scope::begin(const char *name, std::string_view detail)
+{
+    m_active = true;
+    m_event.name = name;
+    m_event.detail = detail;
+    m_event.depth = t_depth++;
+    m_start = std::chrono::steady_clock::now();
+}
+
+void scope::end()
+{
+    auto now = std::chrono::steady_clock::now();
+    --t_depth;
+    m_event.duration = now - m_start;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    m_event.start = m_start - g_epoch;
+    g_events.push_back(std::move(m_event));
+}
+
+void write_text(std::ostream &out, const std::vector<event> &events,
+                const std::vector<counter> &counters)
+{
+    char buffer[32];
+    for (const auto &ev : events)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%10.3f ms  ", to_ms(ev.duration));
+        out << buffer << std::string(static_cast<size_t>(ev.depth) * 2, ' ') << ev.name;
+        if (!ev.detail.empty())
+            out << " [" << ev.detail << "]";
+        out << '\n';
+    }
+    for (const auto &c : counters)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%13lld  ", static_cast<long long>(c.value));
+        out << buffer << c.name << '\n';
+    }
+}
+
+void write_json(std::ostream &out, const std::vector<event> &events,
+                const std::vector<counter> &counters)
+{
+    char buffer[32];
+    out << "{\"version\":";
+    write_json_string(out, version_string());
+    out << ",\"events\":[";
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto &ev = events[i];
+        out << (i ? "," : "") << "{\"name\":";
+        write_json_string(out, ev.name);
+        out << ",\"detail\":";
+        write_json_string(out, ev.detail);
+        std::snprintf(buffer, sizeof(buffer), "%.6f", to_ms(ev.start));
+        out << ",\"depth\":" << ev.depth << ",\"start_ms\":" << buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.6f", to_ms(ev.duration));
+        out << ",\"duration_ms\":" << buffer << "}";
+    }
+    out << "],\"counters\":{";
+    for (size_t i = 0; i < counters.size(); ++i)
+    {
+        out << (i ? "," : "");
+        write_json_string(out, counters[i].name);
+        out << ":" << counters[i].value;
+    }
+    out << "}}\n";
+}
+} // namespace clrsync::core::trace
@@ -0,0 +1,98 @@
+#ifndef CLRSYNC_CORE_TRACE_HPP
+#define CLRSYNC_CORE_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scoped stage timers for diagnosing slow applies. Tracing is off by default; a disabled
+// scope costs one relaxed atomic load and records nothing.
+namespace clrsync::core::trace
+{
+struct event
+{
+    // Stage, e.g. "template.render"; always a string literal.
+    const char *name{""};
+    // What the stage worked on, e.g. a template name; may be empty.
+    std::string detail{};
+    // Nesting level of the scope that recorded the event.
+    int depth{0};
+    // Relative to the moment tracing was enabled.
+    std::chrono::nanoseconds start{0};
+    std::chrono::nanoseconds duration{0};
+};
+
+// A running total recorded alongside the events, e.g. cache hits or bytes saved.
+struct counter
+{
+    // Always a string literal, like event::name.
+    const char *name{""};
+    int64_t value{0};
+};
+
+namespace detail
+{
+extern std::atomic<bool> g_enabled;
+void add(const char *name, int64_t delta);
+}
+
+inline bool enabled()
+{
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+// Enabling clears previously recorded events and counters and restarts the clock.
+void enable(bool on);
+
+// Returns and clears the events recorded so far, ordered by start time.
+std::vector<event> take();
+
+inline void count(const char *name, int64_t delta = 1)
+{
+    if (enabled())
+        detail::add(name, delta);
+}
+
+// Returns and clears the counters, ordered by name.
+std::vector<counter> take_counters();
+
+class scope
+{
+  public:
+    explicit scope(const char *name, std::string_view detail = {})
+    {
+        if (enabled())
+            begin(name, detail);
+    }
+    ~scope()
+    {
+        if (m_active)
+            end();
+    }
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+
+  private:
+    void begin(const char *name, std::string_view detail);
+    void end();
+
+    bool m_active{false};
+    event m_event{};
+    std::chrono::steady_clock::time_point m_start{};
+};
+
+// Human-readable breakdown, one indented line per event, then one line per counter.
+void write_text(std::ostream &out, const std::vector<event> &events,
+                const std::vector<counter> &counters = {});
+
+// {"version": ..., "events": [{"name", "detail", "depth", "start_ms", "duration_ms"}, ...],
+//  "counters": {"<name>": <value>, ...}}
+void write_json(std::ostream &out, const std::vector<event> &events,
+                const std::vector<counter> &counters = {});
+} // namespace clrsync::core::trace
+
+#endif // CLRSYNC_CORE_TRACE_HPP
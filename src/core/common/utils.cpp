@@ -53,4 +53,15 @@ std::filesystem::path normalize_path(const std::string &path)
     return fs_path.lexically_normal();
 }
 
+uint64_t fnv1a64(std::string_view data, uint64_t seed)
+{
+    uint64_t hash = seed;
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
 } // namespace clrsync::core
@@ -1,8 +1,10 @@
 #ifndef CLRSYNC_CORE_UTILS_HPP
 #define CLRSYNC_CORE_UTILS_HPP
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 #include "core/palette/color_keys.hpp"
 
@@ -12,5 +14,7 @@ void print_color_keys();
 std::string get_default_config_path();
 std::string expand_user(const std::string &path);
 std::filesystem::path normalize_path(const std::string &path);
+// 64-bit FNV-1a; `seed` chains several inputs into one hash.
+uint64_t fnv1a64(std::string_view data, uint64_t seed = 0xcbf29ce484222325ULL);
 } // namespace clrsync::core
 #endif // CLRSYNC_CORE_UTILS_HPP
\ No newline at end of file
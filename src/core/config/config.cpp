@@ -1,11 +1,17 @@
 #include "config.hpp"
 #include "core/common/error.hpp"
+#include "core/common/trace.hpp"
 #include "core/common/utils.hpp"
+#include "core/common/version.hpp"
+#include "core/io/file_watcher.hpp"
 #include "core/io/toml_file.hpp"
 
 #include "core/palette/color.hpp"
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <optional>
+#include <sstream>
 
 #ifdef _WIN32
 #include "windows.h"
@@ -20,14 +26,42 @@ config &config::instance()
     return inst;
 }
 
+config::~config()
+{
+    stop_watching();
+}
+
 Result<void> config::initialize(std::unique_ptr<clrsync::core::io::file> file)
 {
+    trace::scope load_scope("config.load");
     copy_default_configs();
     m_file = std::move(file);
+    m_temp_file.reset();
+    m_temp_config_path.clear();
+    m_current = std::make_shared<const config_snapshot>();
+    m_snapshot.store(m_current);
+    m_themes.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        m_pending_file.reset();
+        m_pending_temp_file.reset();
+        m_pending_snapshot.reset();
+        m_has_pending = false;
+        m_batch_open = false;
+    }
+    m_batch_depth = 0;
+    m_batch_dirty = false;
+    ++m_generation;
     if (!m_file)
         return Err<void>(error_code::config_missing, "Config file is missing");
 
     auto parse_result = m_file->parse();
+    if (!parse_result && parse_result.error().code == error_code::file_not_found)
+    {
+        // The seed stamp outlived a deleted config directory; seed again.
+        copy_default_configs(true);
+        parse_result = m_file->parse();
+    }
     if (!parse_result)
         return Err<void>(error_code::config_invalid, parse_result.error().message,
                          parse_result.error().context);
@@ -63,6 +97,8 @@ Result<void> config::initialize(std::unique_ptr<clrsync::core::io::file> file)
         }
     }
 
+    rebuild_snapshot();
+    m_notified = m_current;
     return Ok();
 }
 
@@ -115,32 +151,108 @@ std::filesystem::path config::get_data_dir()
 #endif
 }
 
-void config::copy_file(const std::filesystem::path &src, const std::filesystem::path &dst)
+namespace
 {
-    if (std::filesystem::exists(dst))
-        return;
+constexpr const char *SEED_STAMP_PREFIX = "seeded-";
+
+std::optional<std::string> read_file(const std::filesystem::path &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return std::nullopt;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+bool write_file(const std::filesystem::path &path, const std::string &data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+    return static_cast<bool>(out);
+}
+
+std::filesystem::path seed_stamp_path(const std::filesystem::path &state_dir)
+{
+    return state_dir / (SEED_STAMP_PREFIX + version_string() + ".manifest");
+}
 
-    if (!std::filesystem::exists(src))
+bool is_seed_stamp(const std::filesystem::path &path)
+{
+    auto name = path.filename().string();
+    return name.rfind(SEED_STAMP_PREFIX, 0) == 0 && path.extension() == ".manifest";
+}
+
+// Manifest format: one "<hash> <relative path>" line per seeded file, hash in hex.
+std::map<std::string, uint64_t> read_seed_manifest(const std::filesystem::path &state_dir)
+{
+    std::map<std::string, uint64_t> manifest;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(state_dir, ec))
+    {
+        if (!is_seed_stamp(entry.path()))
+            continue;
+
+        std::ifstream in(entry.path());
+        std::string line;
+        while (std::getline(in, line))
+        {
+            auto space = line.find(' ');
+            if (space == std::string::npos)
+                continue;
+            try
+            {
+                manifest[line.substr(space + 1)] = std::stoull(line.substr(0, space), nullptr, 16);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+    }
+    return manifest;
+}
+} // namespace
+
+void config::seed_file(const std::filesystem::path &src, const std::filesystem::path &dst,
+                       const std::string &rel, const seed_manifest &previous,
+                       seed_manifest &seeded)
+{
+    auto packaged = read_file(src);
+    if (!packaged)
         return;
 
-    std::ifstream in(src, std::ios::binary);
-    std::ofstream out(dst, std::ios::binary);
+    uint64_t hash = fnv1a64(*packaged);
+    seeded[rel] = hash;
 
-    if (!in || !out)
+    std::error_code ec;
+    if (!std::filesystem::exists(dst, ec))
+    {
+        (void)write_file(dst, *packaged);
         return;
+    }
 
-    out << in.rdbuf();
+    // Upgrade files the user never touched: their content still matches what we seeded.
+    auto it = previous.find(rel);
+    if (it == previous.end() || it->second == hash)
+        return;
+    auto current = read_file(dst);
+    if (current && fnv1a64(*current) == it->second)
+        (void)write_file(dst, *packaged);
 }
 
-void config::copy_dir(const std::filesystem::path &src, const std::filesystem::path &dst)
+void config::seed_dir(const std::filesystem::path &src, const std::filesystem::path &dst,
+                      const std::string &rel, const seed_manifest &previous,
+                      seed_manifest &seeded)
 {
-    if (!std::filesystem::exists(src))
+    std::error_code ec;
+    std::filesystem::create_directories(dst, ec);
+    if (!std::filesystem::exists(src, ec))
         return;
 
     for (auto const &entry : std::filesystem::recursive_directory_iterator(src))
     {
-        auto rel = std::filesystem::relative(entry.path(), src);
-        auto out = dst / rel;
+        auto entry_rel = std::filesystem::relative(entry.path(), src);
+        auto out = dst / entry_rel;
 
         if (entry.is_directory())
         {
@@ -148,13 +260,21 @@ void config::copy_dir(const std::filesystem::path &src, const std::filesystem::p
         }
         else if (entry.is_regular_file())
         {
-            copy_file(entry.path(), out);
+            seed_file(entry.path(), out, (std::filesystem::path(rel) / entry_rel).generic_string(),
+                      previous, seeded);
         }
     }
 }
 
-void config::copy_default_configs()
+void config::copy_default_configs(bool force)
 {
+    // Unchanged startups stop here after a single stat.
+    std::filesystem::path state_dir = get_user_state_dir();
+    std::filesystem::path stamp = seed_stamp_path(state_dir);
+    std::error_code ec;
+    if (!force && std::filesystem::exists(stamp, ec))
+        return;
+
     std::filesystem::path user_dir = get_user_config_dir();
     std::filesystem::path system_dir = get_data_dir();
 
@@ -163,107 +283,333 @@ void config::copy_default_configs()
     if (system_dir.empty())
         return;
 
+    auto previous = read_seed_manifest(state_dir);
+    seed_manifest seeded;
+    seed_file(system_dir / "config.toml", user_dir / "config.toml", "config.toml", previous,
+              seeded);
+    seed_dir(system_dir / "templates", user_dir / "templates", "templates", previous, seeded);
+    seed_dir(system_dir / "palettes", user_dir / "palettes", "palettes", previous, seeded);
+
+    for (const auto &entry : std::filesystem::directory_iterator(state_dir, ec))
     {
-        auto src = system_dir / "config.toml";
-        auto dst = user_dir / "config.toml";
-        if (!std::filesystem::exists(dst))
-            copy_file(src, dst);
+        if (is_seed_stamp(entry.path()))
+            std::filesystem::remove(entry.path(), ec);
     }
 
-    {
-        auto src = system_dir / "templates";
-        auto dst = user_dir / "templates";
+    std::ostringstream manifest;
+    for (const auto &[rel, hash] : seeded)
+        manifest << std::hex << hash << ' ' << rel << '\n';
+
+    std::filesystem::create_directories(state_dir, ec);
+    if (!write_file(stamp, manifest.str()))
+        std::cerr << "Warning: Failed to write " << stamp << std::endl;
+}
 
-        if (!std::filesystem::exists(dst))
-            std::filesystem::create_directories(dst);
+io::file *config::write_target()
+{
+    adopt_pending();
+    if (m_temp_config_path.empty())
+        return m_file.get();
 
-        copy_dir(src, dst);
+    if (!m_temp_file)
+    {
+        m_temp_file = std::make_unique<clrsync::core::io::toml_file>(m_temp_config_path);
+        (void)m_temp_file->parse();
     }
+    return m_temp_file.get();
+}
 
+Result<void> config::flush()
+{
+    if (m_batch_depth > 0)
     {
-        auto src = system_dir / "palettes";
-        auto dst = user_dir / "palettes";
+        m_batch_dirty = true;
+        rebuild_snapshot();
+        return Ok();
+    }
 
-        if (!std::filesystem::exists(dst))
-            std::filesystem::create_directories(dst);
+    auto result = write_target()->save_file();
+    rebuild_snapshot();
+    return result;
+}
 
-        copy_dir(src, dst);
+void config::begin()
+{
+    adopt_pending();
+    if (m_batch_depth++ == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        m_batch_open = true;
     }
 }
 
-Result<void> config::save_config_value(const std::string &section, const std::string &key, const value_type &value)
+Result<void> config::commit()
 {
-    if (!m_temp_config_path.empty())
+    if (m_batch_depth == 0)
+        return Err<void>(error_code::invalid_arg, "commit() without matching begin()");
+
+    if (--m_batch_depth > 0)
+        return Ok();
+
+    if (!m_batch_dirty)
     {
-        if (!m_temp_file)
-        {
-            m_temp_file = std::make_unique<clrsync::core::io::toml_file>(m_temp_config_path);
-            (void)m_temp_file->parse();
-        }
-        
-        m_temp_file->set_value(section, key, value);
-        return m_temp_file->save_file();
+        close_batch(false);
+        adopt_pending();
+        return Ok();
     }
-    
-    m_file->set_value(section, key, value);
-    return m_file->save_file();
+
+    // The save replaces whatever the watcher read from disk during the batch.
+    close_batch(true);
+    m_batch_dirty = false;
+    return flush();
 }
 
-const std::string &config::palettes_path()
+void config::rollback()
 {
-    if (m_palettes_dir.empty() && m_file)
+    if (m_batch_depth == 0)
+        return;
+
+    m_batch_depth = 0;
+    close_batch(false);
+    if (m_batch_dirty)
     {
-        if (m_temp_file)
+        m_batch_dirty = false;
+        (void)write_target()->parse();
+        rebuild_snapshot();
+        // update_template() and remove_template() edit the loaded templates directly;
+        // templates() rebuilds them from the restored snapshot.
+        m_themes.clear();
+        ++m_generation;
+    }
+    // A reload from during the batch is newer than what was just re-read.
+    adopt_pending();
+}
+
+void config::close_batch(bool drop_pending)
+{
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+    m_batch_open = false;
+    if (!drop_pending)
+        return;
+    m_pending_file.reset();
+    m_pending_temp_file.reset();
+    m_pending_snapshot.reset();
+    m_has_pending = false;
+}
+
+Result<void> config::save_config_value(const std::string &section, const std::string &key, const value_type &value)
+{
+    write_target()->set_value(section, key, value);
+    return flush();
+}
+
+config_snapshot config::build_snapshot(const io::file *file, const io::file *temp_file)
+{
+    config_snapshot snap;
+    if (!file)
+        return snap;
+
+    auto overlay = [&](const std::string &key) {
+        if (temp_file)
         {
-            auto temp_value = m_temp_file->get_string_value("general", "palettes_path");
+            auto temp_value = temp_file->get_string_value("general", key);
             if (!temp_value.empty())
-            {
-                m_palettes_dir = temp_value;
-                return m_palettes_dir;
-            }
+                return temp_value;
         }
-        m_palettes_dir = m_file->get_string_value("general", "palettes_path");
+        return file->get_string_value("general", key);
+    };
+    snap.font = overlay("font");
+    snap.palettes_path = overlay("palettes_path");
+    snap.default_theme = overlay("default_theme");
+
+    snap.font_size = temp_file ? temp_file->get_uint_value("general", "font_size") : 0;
+    if (snap.font_size == 0)
+        snap.font_size = file->get_uint_value("general", "font_size");
+
+    snap.bundles = file->get_bool_value("general", "bundles") != 0;
+    auto general = file->get_table("general");
+    if (auto *v = std::get_if<std::vector<std::string>>(&general["bundle_palettes"]))
+        snap.bundle_palettes = *v;
+    if (general.count("render_cache_mb"))
+        snap.render_cache_mb = file->get_uint_value("general", "render_cache_mb");
+    if (general.count("gui_sync_hz"))
+        snap.gui_sync_hz = file->get_uint_value("general", "gui_sync_hz");
+
+    for (const auto &t : file->get_table("templates"))
+    {
+        auto current = file->get_table("templates." + t.first);
+        template_settings settings;
+        if (auto *v = std::get_if<std::string>(&current["input_path"]))
+            settings.input_path = *v;
+        if (auto *v = std::get_if<std::string>(&current["output_path"]))
+            settings.output_path = *v;
+        if (auto *v = std::get_if<std::string>(&current["reload_cmd"]))
+            settings.reload_cmd = *v;
+        if (auto *v = std::get_if<bool>(&current["enabled"]))
+            settings.enabled = *v;
+        if (auto *v = std::get_if<std::vector<std::string>>(&current["tags"]))
+            settings.tags = *v;
+        snap.templates.emplace(t.first, std::move(settings));
     }
-    return m_palettes_dir;
+    return snap;
 }
 
-const std::string config::default_theme() const
+void config::rebuild_snapshot()
 {
-    if (m_temp_file)
+    m_current =
+        std::make_shared<const config_snapshot>(build_snapshot(m_file.get(), m_temp_file.get()));
+    m_snapshot.store(m_current);
+}
+
+Result<void> config::watch(const std::filesystem::path &config_path)
+{
+    stop_watching();
+
+    auto watched = normalize_path(config_path.string());
+    std::filesystem::path temp_path = m_temp_config_path;
+
+    auto watcher = std::make_unique<io::file_watcher>();
+    auto result = watcher->add_file(watched);
+    if (!result)
+        return result;
+
+    // Dotfile managers symlink the config; edits land on the link target.
+    std::error_code ec;
+    auto target = std::filesystem::weakly_canonical(watched, ec);
+    if (!ec && target != watched)
     {
-        auto temp_value = m_temp_file->get_string_value("general", "default_theme");
-        if (!temp_value.empty())
-            return temp_value;
+        result = watcher->add_file(target);
+        if (!result)
+            return result;
     }
-    if (m_file)
-        return m_file->get_string_value("general", "default_theme");
-    return {};
+    if (!temp_path.empty())
+    {
+        result = watcher->add_file(temp_path);
+        if (!result)
+            return result;
+    }
+
+    m_watch_stop = false;
+    m_watch_thread = std::thread(&config::watch_loop, this, std::move(watcher), std::move(watched),
+                                 std::move(temp_path));
+    return Ok();
 }
 
-const std::string config::font() const
+void config::stop_watching()
 {
-    if (m_temp_file)
+    if (!m_watch_thread.joinable())
+        return;
+    m_watch_stop = true;
+    m_watch_thread.join();
+}
+
+void config::watch_loop(std::unique_ptr<io::file_watcher> watcher,
+                        std::filesystem::path config_path, std::filesystem::path temp_path)
+{
+    using namespace std::chrono_literals;
+
+    while (!m_watch_stop)
     {
-        auto temp_value = m_temp_file->get_string_value("general", "font");
-        if (!temp_value.empty())
-            return temp_value;
+        // The timeout only bounds how long stop_watching() waits for this thread.
+        auto batch = watcher->wait(20ms, 250ms);
+        if (!batch)
+            return;
+        if (batch.value().paths.empty())
+            continue;
+
+        // A failed parse is usually an editor caught mid-save; keep the last good snapshot.
+        auto file = std::make_unique<io::toml_file>(config_path.string());
+        if (!file->parse())
+            continue;
+
+        std::unique_ptr<io::file> temp_file;
+        if (!temp_path.empty() && std::filesystem::exists(temp_path))
+        {
+            auto temp = std::make_unique<io::toml_file>(temp_path.string());
+            if (temp->parse())
+                temp_file = std::move(temp);
+        }
+
+        auto snap =
+            std::make_shared<const config_snapshot>(build_snapshot(file.get(), temp_file.get()));
+
+        std::function<void()> notify;
+        {
+            std::lock_guard<std::mutex> lock(m_pending_mutex);
+            // An open batch's staged state stays published until the batch ends.
+            if (!m_batch_open)
+                m_snapshot.store(snap);
+            m_pending_file = std::move(file);
+            m_pending_temp_file = std::move(temp_file);
+            m_pending_snapshot = std::move(snap);
+            m_has_pending = true;
+            notify = m_change_notifier;
+        }
+        if (notify)
+            notify();
     }
-    if (m_file)
-        return m_file->get_string_value("general", "font");
-    return {};
 }
 
-const uint32_t config::font_size() const
+void config::set_change_notifier(std::function<void()> notifier)
 {
-    if (m_temp_file)
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+    m_change_notifier = std::move(notifier);
+}
+
+void config::adopt_pending()
+{
+    // Swapping the documents under a staged batch would silently drop its writes.
+    if (m_batch_depth > 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+    if (!m_has_pending)
+        return;
+
+    m_file = std::move(m_pending_file);
+    m_temp_file = std::move(m_pending_temp_file);
+    m_current = std::move(m_pending_snapshot);
+    m_snapshot.store(m_current);
+    m_has_pending = false;
+}
+
+size_t config::subscribe(listener callback)
+{
+    size_t id = m_next_listener++;
+    m_listeners.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void config::unsubscribe(size_t id)
+{
+    std::erase_if(m_listeners, [id](const auto &entry) { return entry.first == id; });
+}
+
+void config::poll()
+{
+    adopt_pending();
+
+    auto current = m_current;
+    if (!m_notified)
+        m_notified = current;
+    if (current == m_notified)
+        return;
+
+    auto diff = config_diff::between(*m_notified, *current);
+    m_notified = current;
+    if (!diff.any())
+        return;
+
+    if (diff.templates)
     {
-        auto temp_value = m_temp_file->get_uint_value("general", "font_size");
-        if (temp_value != 0)
-            return temp_value;
+        m_themes.clear();
+        ++m_generation;
     }
-    if (m_file)
-        return m_file->get_uint_value("general", "font_size");
-    return 14;
+
+    // Copy so that callbacks may subscribe or unsubscribe.
+    auto listeners = m_listeners;
+    for (const auto &[id, callback] : listeners)
+        callback(diff, *current);
 }
 
 Result<void> config::set_default_theme(const std::string &theme)
@@ -304,17 +650,19 @@ Result<void> config::update_template(const std::string &key,
         return Err<void>(error_code::config_missing, "Configuration not initialized");
 
     m_themes[key] = theme_template;
-    
-    auto result1 = save_config_value("templates." + key, "input_path", theme_template.template_path());
-    if (!result1) return result1;
-    
-    auto result2 = save_config_value("templates." + key, "output_path", theme_template.output_path());
-    if (!result2) return result2;
-    
-    auto result3 = save_config_value("templates." + key, "enabled", theme_template.enabled());
-    if (!result3) return result3;
-    
-    return save_config_value("templates." + key, "reload_cmd", theme_template.reload_command());
+    ++m_generation;
+
+    const std::string section = "templates." + key;
+    auto *target = write_target();
+    target->set_value(section, "input_path", theme_template.template_path());
+    target->set_value(section, "output_path", theme_template.output_path());
+    target->set_value(section, "enabled", theme_template.enabled());
+    target->set_value(section, "reload_cmd", theme_template.reload_command());
+    if (theme_template.tags().empty())
+        target->remove_value(section, "tags");
+    else
+        target->set_value(section, "tags", theme_template.tags());
+    return flush();
 }
 
 Result<void> config::remove_template(const std::string &key)
@@ -341,43 +689,22 @@ Result<void> config::remove_template(const std::string &key)
     }
 
     m_themes.erase(it);
+    ++m_generation;
 
-    if (!m_temp_config_path.empty())
-    {
-        if (!m_temp_file)
-        {
-            m_temp_file = std::make_unique<clrsync::core::io::toml_file>(m_temp_config_path);
-            (void)m_temp_file->parse();
-        }
-        m_temp_file->remove_section("templates." + key);
-        return m_temp_file->save_file();
-    }
-    
-    m_file->remove_section("templates." + key);
-    return m_file->save_file();
+    write_target()->remove_section("templates." + key);
+    return flush();
 }
 
-const std::unordered_map<std::string, clrsync::core::theme_template> config::templates()
+const std::unordered_map<std::string, clrsync::core::theme_template> &config::templates()
 {
     if (m_themes.empty() && m_file)
     {
-        auto themes = m_file->get_table("templates");
-        for (const auto &t : themes)
+        for (const auto &[name, settings] : m_current->templates)
         {
-            auto current = m_file->get_table("templates." + t.first);
-            clrsync::core::theme_template theme(t.first,
-                                                std::get<std::string>(current["input_path"]),
-                                                std::get<std::string>(current["output_path"]));
-            if (std::holds_alternative<bool>(current["enabled"]))
-            {
-                theme.set_enabled(std::get<bool>(current["enabled"]));
-            }
-            else
-            {
-                theme.set_enabled(false);
-            }
-            theme.set_reload_command(std::get<std::string>(current["reload_cmd"]));
-            (void)theme.load_template();
+            clrsync::core::theme_template theme(name, settings.input_path, settings.output_path);
+            theme.set_enabled(settings.enabled);
+            theme.set_reload_command(settings.reload_cmd);
+            theme.set_tags(settings.tags);
             m_themes.insert({theme.name(), theme});
         }
     }
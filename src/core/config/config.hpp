@@ -2,14 +2,27 @@
 #define CLRSYNC_CORE_CONFIG_HPP
 
 #include "core/common/error.hpp"
+#include "core/config/config_snapshot.hpp"
 #include "core/io/file.hpp"
 #include "core/theme/theme_template.hpp"
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace clrsync::core
 {
+namespace io
+{
+class file_watcher;
+}
+
 class config
 {
   public:
@@ -17,16 +30,53 @@ class config
 
     Result<void> initialize(std::unique_ptr<clrsync::core::io::file> file);
 
-    const std::string font() const;
-    const uint32_t font_size() const;
-    const std::string &palettes_path();
-    const std::string default_theme() const;
-    const std::unordered_map<std::string, clrsync::core::theme_template> templates();
+    using listener = std::function<void(const config_diff &, const config_snapshot &)>;
+
+    ~config();
+
+    // Safe from any thread; the returned snapshot stays valid for as long as the caller holds
+    // it, even if a newer one is published in the meantime.
+    std::shared_ptr<const config_snapshot> snapshot() const
+    {
+        return m_snapshot.load();
+    }
+    // Owner thread only. These read the snapshot adopted by the last poll() or local write, so
+    // a returned reference stays valid until the next one.
+    const std::string &font() const
+    {
+        return m_current->font;
+    }
+    uint32_t font_size() const
+    {
+        return m_current->font_size;
+    }
+    const std::string &palettes_path() const
+    {
+        return m_current->palettes_path;
+    }
+    const std::string &default_theme() const
+    {
+        return m_current->default_theme;
+    }
+    // Template metadata only; content is loaded by the template on first use.
+    const std::unordered_map<std::string, clrsync::core::theme_template> &templates();
     Result<const clrsync::core::theme_template *> template_by_name(const std::string &name) const;
+    // Bumped whenever the loaded config or its template set changes.
+    uint64_t generation() const
+    {
+        return m_generation;
+    }
     std::filesystem::path get_user_config_dir();
     std::filesystem::path get_user_state_dir();
     std::filesystem::path get_writable_config_path();
 
+    // Stages every write until the matching commit(), which saves the file once.
+    // Batches nest; only the outermost commit() touches disk.
+    void begin();
+    Result<void> commit();
+    // Drops staged writes by re-reading the file from disk.
+    void rollback();
+
     Result<void> set_default_theme(const std::string &theme);
     Result<void> set_palettes_path(const std::string &path);
     Result<void> set_font(const std::string &font);
@@ -37,20 +87,72 @@ class config
     Result<void> remove_template(const std::string &key);
     static std::filesystem::path get_data_dir();
 
+    // Re-reads the config (and temp overlay) on a background thread whenever it changes on
+    // disk and publishes a fresh snapshot; during a batch it is held back until the batch
+    // ends. Subscribers are only called from poll().
+    Result<void> watch(const std::filesystem::path &config_path);
+    void stop_watching();
+
+    size_t subscribe(listener callback);
+    void unsubscribe(size_t id);
+    // Adopts reloaded files and notifies subscribers of everything that changed since the
+    // previous poll, including local writes. Call from the thread that owns the config.
+    void poll();
+    // Called on the watcher thread once a reload is waiting for poll(), so a loop that
+    // sleeps between polls can wake up. Must be thread-safe and must not touch the config.
+    void set_change_notifier(std::function<void()> notifier);
+
   private:
     config() = default;
     config(const config &) = delete;
     config &operator=(const config &) = delete;
 
-    std::string m_palettes_dir{};
+    atomic_snapshot m_snapshot;
+    // What the owner thread reads; m_snapshot may already hold a newer reload.
+    std::shared_ptr<const config_snapshot> m_current{std::make_shared<const config_snapshot>()};
     std::unique_ptr<io::file> m_file;
     std::unique_ptr<io::file> m_temp_file; 
     std::string m_temp_config_path;
     std::unordered_map<std::string, theme_template> m_themes{};
+    uint64_t m_generation{0};
+    int m_batch_depth{0};
+    bool m_batch_dirty{false};
+
+    std::thread m_watch_thread;
+    std::atomic<bool> m_watch_stop{false};
+    std::mutex m_pending_mutex;
+    std::unique_ptr<io::file> m_pending_file;
+    std::unique_ptr<io::file> m_pending_temp_file;
+    std::shared_ptr<const config_snapshot> m_pending_snapshot;
+    bool m_has_pending{false};
+    // Mirrors m_batch_depth > 0 for the watcher thread, which must not publish over the
+    // staged state of an open batch.
+    bool m_batch_open{false};
+    std::function<void()> m_change_notifier;
+
+    std::vector<std::pair<size_t, listener>> m_listeners;
+    size_t m_next_listener{1};
+    std::shared_ptr<const config_snapshot> m_notified;
+
+    void watch_loop(std::unique_ptr<io::file_watcher> watcher, std::filesystem::path config_path,
+                    std::filesystem::path temp_path);
+    void adopt_pending();
+    void close_batch(bool drop_pending);
+    io::file *write_target();
+    Result<void> flush();
+    void rebuild_snapshot();
+    static config_snapshot build_snapshot(const io::file *file, const io::file *temp_file);
     Result<void> save_config_value(const std::string &section, const std::string &key, const value_type &value);
-    static void copy_file(const std::filesystem::path &src, const std::filesystem::path &dst);
-    static void copy_dir(const std::filesystem::path &src, const std::filesystem::path &dst);
-    void copy_default_configs();
+    // relative path -> FNV-1a hash of the packaged content that was seeded
+    using seed_manifest = std::map<std::string, uint64_t>;
+    static void seed_file(const std::filesystem::path &src, const std::filesystem::path &dst,
+                          const std::string &rel, const seed_manifest &previous,
+                          seed_manifest &seeded);
+    static void seed_dir(const std::filesystem::path &src, const std::filesystem::path &dst,
+                         const std::string &rel, const seed_manifest &previous,
+                         seed_manifest &seeded);
+    // Seeds packaged defaults once per package version; `force` ignores the stamp.
+    void copy_default_configs(bool force = false);
 };
 } // namespace clrsync::core
 
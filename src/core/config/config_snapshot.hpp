@@ -0,0 +1,115 @@
+#ifndef CLRSYNC_CORE_CONFIG_SNAPSHOT_HPP
+#define CLRSYNC_CORE_CONFIG_SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clrsync::core
+{
+// One [templates.<name>] table as written in the config.
+struct template_settings
+{
+    std::string input_path{};
+    std::string output_path{};
+    std::string reload_cmd{};
+    std::vector<std::string> tags{};
+    bool enabled{false};
+
+    bool operator==(const template_settings &) const = default;
+};
+
+// Typed view of the config with the temp-file overlay already applied. Snapshots are
+// immutable once published, so a reader holding one never observes a partial update.
+struct config_snapshot
+{
+    std::string font{};
+    uint32_t font_size{14};
+    std::string palettes_path{};
+    std::string default_theme{};
+    // Pre-render outputs per palette and switch between them with a symlink; see
+    // bundle_store. An empty bundle_palettes builds bundles for every palette.
+    bool bundles{false};
+    std::vector<std::string> bundle_palettes{};
+    // Size bound of the on-disk render cache in MiB; 0 disables it.
+    uint32_t render_cache_mb{64};
+    // Updates per second the GUI's template editor and settings window get while a color
+    // picker is dragged; 0 updates them every frame.
+    uint32_t gui_sync_hz{20};
+    std::map<std::string, template_settings> templates{};
+};
+
+// What differs between two snapshots; handed to config subscribers.
+struct config_diff
+{
+    bool font{false};
+    bool font_size{false};
+    bool palettes_path{false};
+    bool default_theme{false};
+    bool bundles{false};
+    bool render_cache{false};
+    bool gui_sync{false};
+    bool templates{false};
+
+    static config_diff between(const config_snapshot &before, const config_snapshot &after)
+    {
+        config_diff diff;
+        diff.font = before.font != after.font;
+        diff.font_size = before.font_size != after.font_size;
+        diff.palettes_path = before.palettes_path != after.palettes_path;
+        diff.default_theme = before.default_theme != after.default_theme;
+        diff.bundles =
+            before.bundles != after.bundles || before.bundle_palettes != after.bundle_palettes;
+        diff.render_cache = before.render_cache_mb != after.render_cache_mb;
+        diff.gui_sync = before.gui_sync_hz != after.gui_sync_hz;
+        diff.templates = before.templates != after.templates;
+        return diff;
+    }
+
+    bool any() const
+    {
+        return font || font_size || palettes_path || default_theme || bundles || render_cache ||
+               gui_sync || templates;
+    }
+};
+
+// Publication slot for the current snapshot, shared between the config watcher and other
+// threads. Not lock-free: libstdc++'s std::atomic<std::shared_ptr> and the atomic free
+// functions libc++ falls back to both guard the pointer with a lock, so owner-thread reads go
+// through config's own copy instead.
+class atomic_snapshot
+{
+  public:
+    using pointer = std::shared_ptr<const config_snapshot>;
+
+    pointer load() const
+    {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return m_ptr.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&m_ptr, std::memory_order_acquire);
+#endif
+    }
+
+    void store(pointer ptr)
+    {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        m_ptr.store(std::move(ptr), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&m_ptr, std::move(ptr), std::memory_order_release);
+#endif
+    }
+
+  private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<pointer> m_ptr{std::make_shared<const config_snapshot>()};
+#else
+    pointer m_ptr{std::make_shared<const config_snapshot>()};
+#endif
+};
+} // namespace clrsync::core
+
+#endif // CLRSYNC_CORE_CONFIG_SNAPSHOT_HPP
@@ -5,8 +5,9 @@
 #include <map>
 #include <string>
 #include <variant>
+#include <vector>
 
-using value_type = std::variant<std::string, uint32_t, int, bool>;
+using value_type = std::variant<std::string, uint32_t, int, bool, std::vector<std::string>>;
 
 namespace clrsync::core::io
 {
@@ -44,6 +45,7 @@ class file
     }
     virtual void insert_or_update_value(const std::string &section, const std::string &key,
                                         const value_type &value) {};
+    virtual void remove_value(const std::string &section, const std::string &key) {};
     virtual void remove_section(const std::string &section) {};
     virtual Result<void> save_file()
     {
@@ -0,0 +1,39 @@
+#include "core/io/file_stamp.hpp"
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace clrsync::core::io
+{
+bool read_file_stamp(const std::filesystem::path &path, file_stamp &out)
+{
+#ifdef _WIN32
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return false;
+    out.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch())
+                       .count();
+    out.size = size;
+    out.inode = 0;
+    return true;
+#else
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0)
+        return false;
+#ifdef __APPLE__
+    out.mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 +
+                   st.st_mtimespec.tv_nsec;
+#else
+    out.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    out.size = static_cast<uint64_t>(st.st_size);
+    out.inode = static_cast<uint64_t>(st.st_ino);
+    return true;
+#endif
+}
+} // namespace clrsync::core::io
@@ -0,0 +1,23 @@
+#ifndef CLRSYNC_CORE_IO_FILE_STAMP_HPP
+#define CLRSYNC_CORE_IO_FILE_STAMP_HPP
+
+#include <cstdint>
+#include <filesystem>
+
+namespace clrsync::core::io
+{
+// Cheap identity of a file on disk: if none of these change, the content is assumed unchanged.
+struct file_stamp
+{
+    int64_t mtime_ns{0};
+    uint64_t size{0};
+    uint64_t inode{0};
+
+    bool operator==(const file_stamp &other) const = default;
+};
+
+// Returns false if the file does not exist or cannot be stat'ed.
+bool read_file_stamp(const std::filesystem::path &path, file_stamp &out);
+} // namespace clrsync::core::io
+
+#endif
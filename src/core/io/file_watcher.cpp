@@ -0,0 +1,209 @@
+#include "core/io/file_watcher.hpp"
+#include "core/common/utils.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace clrsync::core::io
+{
+#ifdef __linux__
+
+namespace
+{
+constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE |
+                                IN_DELETE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+
+int wait_readable(int epoll_fd, int timeout_ms)
+{
+    epoll_event ev{};
+    int n;
+    do
+    {
+        n = epoll_wait(epoll_fd, &ev, 1, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+} // namespace
+
+file_watcher::file_watcher()
+{
+    m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_inotify_fd >= 0 && m_epoll_fd >= 0)
+    {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = m_inotify_fd;
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_inotify_fd, &ev);
+    }
+}
+
+file_watcher::~file_watcher()
+{
+    if (m_epoll_fd >= 0)
+        close(m_epoll_fd);
+    if (m_inotify_fd >= 0)
+        close(m_inotify_fd);
+}
+
+Result<void> file_watcher::add_watch(const std::filesystem::path &dir, const std::string &file)
+{
+    if (m_inotify_fd < 0 || m_epoll_fd < 0)
+        return Err<void>(error_code::init_failed, "Failed to initialize inotify",
+                         std::strerror(errno));
+
+    auto it = m_dir_handles.find(dir.string());
+    int wd;
+    if (it != m_dir_handles.end())
+    {
+        wd = it->second;
+    }
+    else
+    {
+        wd = inotify_add_watch(m_inotify_fd, dir.c_str(), WATCH_MASK);
+        if (wd < 0)
+            return Err<void>(error_code::file_not_found, std::strerror(errno), dir.string());
+        m_dir_handles[dir.string()] = wd;
+        m_watches[wd].dir = dir;
+    }
+
+    auto &watch = m_watches[wd];
+    if (file.empty())
+        watch.whole_dir = true;
+    else
+        watch.files.insert(file);
+    return Ok();
+}
+
+Result<void> file_watcher::add_directory(const std::filesystem::path &dir)
+{
+    return add_watch(normalize_path(dir.string()), {});
+}
+
+Result<void> file_watcher::add_file(const std::filesystem::path &file)
+{
+    auto path = normalize_path(file.string());
+    return add_watch(path.parent_path(), path.filename().string());
+}
+
+void file_watcher::clear()
+{
+    for (const auto &[wd, watch] : m_watches)
+        inotify_rm_watch(m_inotify_fd, wd);
+    m_watches.clear();
+    m_dir_handles.clear();
+}
+
+void file_watcher::drain(watch_batch &batch, std::unordered_set<std::string> &seen)
+{
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;)
+    {
+        ssize_t len = read(m_inotify_fd, buffer, sizeof(buffer));
+        if (len <= 0)
+            return;
+
+        for (char *ptr = buffer; ptr < buffer + len;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            auto it = m_watches.find(event->wd);
+            if (it == m_watches.end())
+                continue;
+
+            const auto &watch = it->second;
+            std::string name = event->len ? std::string(event->name) : std::string{};
+            if (!watch.whole_dir && (name.empty() || !watch.files.count(name)))
+                continue;
+
+            auto path = name.empty() ? watch.dir : watch.dir / name;
+            if (seen.insert(path.string()).second)
+            {
+                if (batch.paths.empty())
+                    batch.first_event = std::chrono::steady_clock::now();
+                batch.paths.push_back(std::move(path));
+            }
+        }
+    }
+}
+
+Result<watch_batch> file_watcher::wait(std::chrono::milliseconds quiet,
+                                       std::chrono::milliseconds timeout)
+{
+    if (m_inotify_fd < 0 || m_epoll_fd < 0)
+        return Err<watch_batch>(error_code::init_failed, "Failed to initialize inotify");
+
+    watch_batch batch;
+    std::unordered_set<std::string> seen;
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (batch.paths.empty())
+    {
+        int wait_ms = -1;
+        if (timeout.count() >= 0)
+        {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            wait_ms = static_cast<int>(std::max<int64_t>(0, left.count()));
+        }
+
+        int n = wait_readable(m_epoll_fd, wait_ms);
+        if (n < 0)
+            return Err<watch_batch>(error_code::unknown, "epoll_wait failed", std::strerror(errno));
+        if (n == 0)
+            return batch;
+        drain(batch, seen);
+    }
+
+    // A negative timeout would make epoll_wait block until the next event.
+    const int quiet_ms = static_cast<int>(std::max<int64_t>(0, quiet.count()));
+    while (wait_readable(m_epoll_fd, quiet_ms) > 0)
+        drain(batch, seen);
+
+    return batch;
+}
+
+int file_watcher::native_handle() const
+{
+    return m_epoll_fd;
+}
+
+#else
+
+file_watcher::file_watcher() = default;
+file_watcher::~file_watcher() = default;
+
+Result<void> file_watcher::add_directory(const std::filesystem::path &)
+{
+    return Err<void>(error_code::init_failed, "File watching is not supported on this platform");
+}
+
+Result<void> file_watcher::add_file(const std::filesystem::path &)
+{
+    return Err<void>(error_code::init_failed, "File watching is not supported on this platform");
+}
+
+void file_watcher::clear()
+{
+}
+
+Result<watch_batch> file_watcher::wait(std::chrono::milliseconds, std::chrono::milliseconds)
+{
+    return Err<watch_batch>(error_code::init_failed,
+                            "File watching is not supported on this platform");
+}
+
+int file_watcher::native_handle() const
+{
+    return -1;
+}
+
+#endif
+} // namespace clrsync::core::io
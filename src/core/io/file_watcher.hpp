@@ -0,0 +1,65 @@
+#ifndef CLRSYNC_CORE_IO_FILE_WATCHER_HPP
+#define CLRSYNC_CORE_IO_FILE_WATCHER_HPP
+
+#include "core/common/error.hpp"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace clrsync::core::io
+{
+struct watch_batch
+{
+    // Changed paths, deduplicated, in the order they were first seen.
+    std::vector<std::filesystem::path> paths;
+    // When the first event of the batch was read; used to measure end-to-end latency.
+    std::chrono::steady_clock::time_point first_event;
+};
+
+// Watches files and directories for changes (inotify + epoll on Linux).
+// Files are watched through their parent directory so that editors which save by writing a
+// temporary file and renaming it over the original are still picked up.
+class file_watcher
+{
+  public:
+    file_watcher();
+    ~file_watcher();
+    file_watcher(const file_watcher &) = delete;
+    file_watcher &operator=(const file_watcher &) = delete;
+
+    Result<void> add_directory(const std::filesystem::path &dir);
+    Result<void> add_file(const std::filesystem::path &file);
+    void clear();
+
+    // Blocks until a watched path changes or `timeout` expires (negative waits forever), then
+    // keeps collecting events until none arrived for `quiet`, so a burst of write + rename +
+    // chmod from one save is reported once. An empty batch means the timeout expired.
+    Result<watch_batch> wait(std::chrono::milliseconds quiet,
+                             std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
+    // Descriptor that becomes readable when events are pending, for callers with their own
+    // poll loop; -1 when unsupported.
+    int native_handle() const;
+
+  private:
+    struct watched_dir
+    {
+        std::filesystem::path dir;
+        bool whole_dir{false};
+        std::unordered_set<std::string> files;
+    };
+
+    Result<void> add_watch(const std::filesystem::path &dir, const std::string &file);
+    void drain(watch_batch &batch, std::unordered_set<std::string> &seen);
+
+    int m_inotify_fd{-1};
+    int m_epoll_fd{-1};
+    std::unordered_map<int, watched_dir> m_watches;
+    std::unordered_map<std::string, int> m_dir_handles;
+};
+} // namespace clrsync::core::io
+
+#endif
@@ -1,7 +1,9 @@
 #include "core/io/toml_file.hpp"
 #include "core/common/utils.hpp"
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <type_traits>
 #include <vector>
 
 namespace clrsync::core::io
@@ -16,7 +18,14 @@ Result<void> toml_file::parse()
     if (!std::filesystem::exists(m_path))
         return Err<void>(error_code::file_not_found, "File does not exist", m_path);
 
-    m_file = toml::parse_file(m_path);
+    try
+    {
+        m_file = toml::parse_file(m_path);
+    }
+    catch (const toml::parse_error &e)
+    {
+        return Err<void>(error_code::parse_failed, std::string(e.description()), m_path);
+    }
     return Ok();
 }
 
@@ -43,7 +52,9 @@ std::map<std::string, value_type> toml_file::get_table(const std::string &sectio
 
     for (const auto &part : parts)
     {
-        if (auto subtbl = tbl->at(part).as_table())
+        // table::at() throws for a missing key; a missing section is just an empty table.
+        const toml::node *node = tbl->get(part);
+        if (auto subtbl = node ? node->as_table() : nullptr)
             tbl = subtbl;
         else
             return {};
@@ -62,7 +73,19 @@ std::map<std::string, value_type> toml_file::get_table(const std::string &sectio
         else if (auto i = val.value<int64_t>())
             result[std::string(p.first.str())] = static_cast<uint32_t>(*i);
         else if (auto d = val.value<double>())
-            result[std::string(p.first.str())] = static_cast<uint32_t>(*d);
+            result[std::string(p.first.str())] =
+                *d >= 0.0 && *d <= static_cast<double>(UINT32_MAX) ? static_cast<uint32_t>(*d)
+                                                                   : 0u;
+        else if (auto arr = val.as_array())
+        {
+            std::vector<std::string> items;
+            for (const auto &item : *arr)
+            {
+                if (auto s = item.value<std::string>())
+                    items.push_back(*s);
+            }
+            result[std::string(p.first.str())] = std::move(items);
+        }
         else
             result[std::string(p.first.str())] = {};
     }
@@ -89,7 +112,34 @@ void toml_file::insert_or_update_value(const std::string &section, const std::st
         tbl = sub;
     }
 
-    std::visit([&](auto &&v) { tbl->insert_or_assign(key, v); }, value);
+    std::visit(
+        [&](auto &&v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::vector<std::string>>)
+            {
+                toml::array arr;
+                for (const auto &item : v)
+                    arr.push_back(item);
+                tbl->insert_or_assign(key, std::move(arr));
+            }
+            else
+            {
+                tbl->insert_or_assign(key, v);
+            }
+        },
+        value);
+}
+
+void toml_file::remove_value(const std::string &section, const std::string &key)
+{
+    toml::table *tbl = m_file.as_table();
+    for (const auto &part : split(section, '.'))
+    {
+        tbl = (*tbl)[part].as_table();
+        if (!tbl)
+            return;
+    }
+    tbl->erase(key);
 }
 
 void toml_file::remove_section(const std::string &section)
@@ -113,22 +163,50 @@ void toml_file::remove_section(const std::string &section)
 
 Result<void> toml_file::save_file()
 {
+    // Write through symlinks (dotfile managers) instead of replacing the link itself.
+    std::error_code ec;
+    std::filesystem::path target = std::filesystem::weakly_canonical(m_path, ec);
+    if (ec)
+        target = m_path;
+
     try
     {
-        std::filesystem::create_directories(std::filesystem::path(m_path).parent_path());
+        std::filesystem::create_directories(target.parent_path());
     }
     catch (const std::exception &e)
     {
         return Err<void>(error_code::dir_create_failed, e.what(), m_path);
     }
 
-    std::ofstream stream(m_path, std::ios::binary);
-    if (!stream)
-        return Err<void>(error_code::file_write_failed, "Failed to open file for writing", m_path);
+    // Serialize next to the target and rename over it, so readers never see a partial file.
+    std::filesystem::path temp = target;
+    temp += ".tmp";
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            return Err<void>(error_code::file_write_failed, "Failed to open file for writing",
+                             temp.string());
+
+        stream << m_file;
+        stream.flush();
+        if (!stream)
+        {
+            stream.close();
+            std::filesystem::remove(temp, ec);
+            return Err<void>(error_code::file_write_failed, "Failed to write to file", m_path);
+        }
+    }
 
-    stream << m_file;
-    if (!stream)
-        return Err<void>(error_code::file_write_failed, "Failed to write to file", m_path);
+    auto perms = std::filesystem::status(target, ec).permissions();
+    if (!ec && perms != std::filesystem::perms::unknown)
+        std::filesystem::permissions(temp, perms, ec);
+
+    std::filesystem::rename(temp, target, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp, ec);
+        return Err<void>(error_code::file_write_failed, "Failed to replace file", m_path);
+    }
 
     return Ok();
 }
@@ -3,6 +3,13 @@
 #include "core/common/error.hpp"
 #include "core/io/file.hpp"
 #include <string>
+
+// Under NDEBUG toml++ turns its parser asserts into optimizer assumptions, and at least one
+// of them is reachable from malformed input ("[ =" in parse_key), which would make parsing
+// a broken config undefined behaviour. Keep them as no-ops instead.
+#ifndef TOML_ASSUME
+#define TOML_ASSUME(expr) static_cast<void>(0)
+#endif
 #include <toml/toml.hpp>
 
 namespace clrsync::core::io
@@ -19,6 +26,7 @@ class toml_file : public file
     std::map<std::string, value_type> get_table(const std::string &section_path) const override;
     void insert_or_update_value(const std::string &section, const std::string &key,
                                 const value_type &value) override;
+    void remove_value(const std::string &section, const std::string &key) override;
     void remove_section(const std::string &section) override;
     Result<void> save_file() override;
 
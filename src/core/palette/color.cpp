@@ -1,5 +1,6 @@
 #include "color.hpp"
 #include <algorithm>
+#include <charconv>
 #include <cstdio>
 #include <format>
 #include <stdexcept>
@@ -108,22 +109,19 @@ hsla color::to_hsla() const
 
 void color::from_hex_string(const std::string &str)
 {
-    if (str.empty() || str[0] != '#')
+    if (str.empty() || str[0] != '#' || (str.size() != 7 && str.size() != 9))
         throw std::invalid_argument("Invalid hex color format");
 
-    if (str.size() == 7)
-    {
-        uint32_t rgb = static_cast<uint32_t>(std::stoul(str.substr(1), nullptr, 16));
-        m_hex = (rgb << 8) | 0xFF;
-    }
-    else if (str.size() == 9)
-    {
-        m_hex = static_cast<uint32_t>(std::stoul(str.substr(1), nullptr, 16));
-    }
-    else
-    {
+    // std::stoul stopped at the first bad digit and accepted signs and whitespace, so
+    // "#12zzzz" silently became 0x000012ff; every digit has to be hex.
+    uint32_t value = 0;
+    const char *first = str.data() + 1;
+    const char *last = str.data() + str.size();
+    auto [ptr, ec] = std::from_chars(first, last, value, 16);
+    if (ec != std::errc{} || ptr != last)
         throw std::invalid_argument("Invalid hex color format");
-    }
+
+    m_hex = str.size() == 7 ? (value << 8) | 0xFF : value;
 }
 
 const std::string color::to_hex_string() const
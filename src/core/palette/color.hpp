@@ -64,6 +64,8 @@ class color
 
     void set(uint32_t hex);
 
+    bool operator==(const color &other) const = default;
+
   private:
     uint32_t m_hex = 0x00000000;
 };
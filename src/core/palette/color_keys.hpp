@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <iterator>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace clrsync::core
@@ -76,6 +77,38 @@ constexpr const char *COLOR_KEYS[] = {
 
 constexpr size_t NUM_COLOR_KEYS = std::size(COLOR_KEYS);
 
+// Index of `key` in COLOR_KEYS, or NUM_COLOR_KEYS if it is not one.
+constexpr size_t color_key_index(std::string_view key)
+{
+    for (size_t i = 0; i < NUM_COLOR_KEYS; ++i)
+    {
+        if (key == COLOR_KEYS[i])
+            return i;
+    }
+    return NUM_COLOR_KEYS;
+}
+
+// A key named in code, resolved to its COLOR_KEYS index at compile time; a misspelled key does
+// not compile. A default-constructed color_key names no key.
+class color_key
+{
+  public:
+    constexpr color_key() = default;
+    consteval color_key(const char *name) : m_index(color_key_index(name))
+    {
+        if (m_index == NUM_COLOR_KEYS)
+            throw "not a color key";
+    }
+
+    constexpr size_t index() const
+    {
+        return m_index;
+    }
+
+  private:
+    size_t m_index{NUM_COLOR_KEYS};
+};
+
 inline const std::unordered_map<std::string, uint32_t> DEFAULT_COLORS = {
     {"background", 0x111111ff},
     {"on_background", 0xd4d4d4ff},
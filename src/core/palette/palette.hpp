@@ -1,6 +1,7 @@
 #ifndef CLRSYNC_CORE_PALETTE_PALETTE_HPP
 #define CLRSYNC_CORE_PALETTE_PALETTE_HPP
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -68,5 +69,9 @@ class palette
     std::unordered_map<std::string, color> m_colors{};
     std::string m_file_path{};
 };
+
+// Palettes are shared read-only between the manager, the GUI and whatever renders them, so
+// passing one around never copies its colors. Editing means copying into a new palette.
+using palette_ptr = std::shared_ptr<const palette>;
 } // namespace clrsync::core
 #endif
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "core/palette/color_keys.hpp"
 #include "core/palette/palette.hpp"
 
+#include <exception>
 #include <memory>
 
 namespace clrsync::core
@@ -42,7 +43,14 @@ template <typename FileType> class palette_file
             if (!color_str.empty())
             {
                 core::color color;
-                color.from_hex_string(color_str);
+                try
+                {
+                    color.from_hex_string(color_str);
+                }
+                catch (const std::exception &)
+                {
+                    return false;
+                }
                 m_palette.set_color(color_key, color);
             }
         }
@@ -1,11 +1,14 @@
 #ifndef CLRSYNC_CORE_PALETTE_PALETTE_MANAGER_HPP
 #define CLRSYNC_CORE_PALETTE_PALETTE_MANAGER_HPP
 
+#include "core/common/trace.hpp"
 #include "core/common/utils.hpp"
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "core/config/config.hpp"
+#include "core/io/file_stamp.hpp"
 #include "core/palette/palette.hpp"
 #include "core/palette/palette_file.hpp"
 #include <filesystem>
@@ -16,19 +19,65 @@ template <typename FileType> class palette_manager
 {
   public:
     palette_manager() = default;
+    // Rescans the directory, re-parsing only files whose stamp changed since the last scan.
     void load_palettes_from_directory(const std::string &directory_path)
     {
+        trace::scope scan_scope("palettes.scan", directory_path);
         std::filesystem::path directory_path_expanded = normalize_path(directory_path);
-        if (!std::filesystem::exists(directory_path_expanded))
-            return;
-        for (const auto &entry : std::filesystem::directory_iterator(directory_path_expanded))
+        if (directory_path_expanded != m_directory)
+        {
+            m_directory = directory_path_expanded;
+            m_palettes.clear();
+            m_file_cache.clear();
+        }
+
+        std::unordered_set<std::string> seen;
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator(directory_path_expanded, ec))
+        {
+            if (!entry.is_regular_file(ec))
+                continue;
+
+            io::file_stamp stamp;
+            if (!io::read_file_stamp(entry.path(), stamp))
+                continue;
+
+            const std::string path = entry.path().string();
+            seen.insert(path);
+
+            auto cached = m_file_cache.find(path);
+            if (cached != m_file_cache.end() && cached->second.stamp == stamp)
+                continue;
+
+            if (cached != m_file_cache.end() && cached->second.pal)
+                evict(path, cached->second.pal->name());
+
+            trace::scope parse_scope("palette.parse", path);
+            palette_file<FileType> pal_file(path);
+            if (!pal_file.parse())
+            {
+                // Remember the stamp so the broken file is not re-parsed until it changes.
+                m_file_cache[path] = {stamp, nullptr};
+                continue;
+            }
+
+            auto pal = std::make_shared<const palette>(pal_file.palette());
+            m_file_cache[path] = {stamp, pal};
+            add_palette(std::move(pal));
+        }
+
+        for (auto cached = m_file_cache.begin(); cached != m_file_cache.end();)
         {
-            if (entry.is_regular_file())
+            if (seen.count(cached->first))
             {
-                palette_file<FileType> pal_file(entry.path().string());
-                if (pal_file.parse())
-                    add_palette(pal_file.palette());
+                ++cached;
+                continue;
             }
+            std::string path = cached->first;
+            palette_ptr pal = cached->second.pal;
+            cached = m_file_cache.erase(cached);
+            if (pal)
+                evict(path, pal->name());
         }
     }
     void save_palette_to_file(const palette &pal, const std::string &directory_path) const
@@ -41,36 +90,72 @@ template <typename FileType> class palette_manager
 
     const palette load_palette_from_file(const std::string &file_path) const
     {
+        trace::scope parse_scope("palette.parse", file_path);
         palette_file<FileType> pal_file(file_path);
         if (pal_file.parse())
             return pal_file.palette(); // TODO: report missing/invalid file
         return {};
     }
-    void add_palette(const palette &pal)
+    void add_palette(palette_ptr pal)
     {
-        m_palettes[pal.name()] = pal;
+        const std::string name = pal->name();
+        m_palettes[name] = std::move(pal);
     }
     void delete_palette(const std::string &file_path, const std::string &name)
     {
         std::filesystem::remove(file_path);
-        m_palettes.erase(name);
+        m_file_cache.erase(file_path);
+        evict(file_path, name);
     }
     const palette *get_palette(const std::string &name) const
     {
         auto it = m_palettes.find(name);
         if (it != m_palettes.end())
         {
-            return &it->second;
+            return it->second.get();
         }
         return nullptr;
     }
-    const std::unordered_map<std::string, palette> &palettes() const
+    // Shares the palette instead of pointing into the manager, so it outlives rescans.
+    palette_ptr find_palette(const std::string &name) const
+    {
+        auto it = m_palettes.find(name);
+        return it != m_palettes.end() ? it->second : nullptr;
+    }
+    const std::unordered_map<std::string, palette_ptr> &palettes() const
     {
         return m_palettes;
     }
 
   private:
-    std::unordered_map<std::string, palette> m_palettes{};
+    struct cached_file
+    {
+        io::file_stamp stamp;
+        // Null if the file did not parse.
+        palette_ptr pal;
+    };
+
+    // Drops the palette parsed from `path`; if another cached file carries the same name it
+    // takes over, so a shadowed palette reappears once its twin is gone.
+    void evict(const std::string &path, const std::string &name)
+    {
+        auto it = m_palettes.find(name);
+        if (it == m_palettes.end() || it->second->file_path() != path)
+            return;
+        m_palettes.erase(it);
+        for (const auto &[other_path, entry] : m_file_cache)
+        {
+            if (other_path != path && entry.pal && entry.pal->name() == name)
+            {
+                add_palette(entry.pal);
+                break;
+            }
+        }
+    }
+
+    std::unordered_map<std::string, palette_ptr> m_palettes{};
+    std::unordered_map<std::string, cached_file> m_file_cache{};
+    std::filesystem::path m_directory{};
 };
 } // namespace clrsync::core
 #endif
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "bundle_store.hpp"
+#include "core/common/trace.hpp"
+#include "core/config/config.hpp"
+#include "core/theme/render_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <unordered_set>
+
+namespace clrsync::core
+{
+namespace
+{
+namespace fs = std::filesystem;
+
+constexpr const char *CURRENT_LINK = "current";
+constexpr const char *MANIFEST_NAME = ".manifest";
+
+// Writes next to `path` and renames over it: outputs of the active bundle are live, and a
+// program reloading mid-write must never see half a file.
+Result<void> write_atomically(const fs::path &path, const std::string &data)
+{
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return Err<void>(error_code::file_write_failed, "Failed to open file for writing",
+                             temp.string());
+        out << data;
+        out.flush();
+        if (!out)
+            return Err<void>(error_code::file_write_failed, "Failed to write to file",
+                             temp.string());
+    }
+
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec)
+    {
+        fs::remove(temp, ec);
+        return Err<void>(error_code::file_write_failed, "Failed to replace file", path.string());
+    }
+    return Ok();
+}
+
+// Replaces whatever is at `link` with a symlink to `target` in one rename().
+Result<void> replace_symlink(const fs::path &target, const fs::path &link)
+{
+    fs::path temp = link;
+    temp += ".tmp";
+    std::error_code ec;
+    fs::remove(temp, ec);
+    fs::create_symlink(target, temp, ec);
+    if (ec)
+        return Err<void>(error_code::file_write_failed, "Failed to create symlink: " + ec.message(),
+                         temp.string());
+
+    fs::rename(temp, link, ec);
+    if (ec)
+    {
+        fs::remove(temp, ec);
+        return Err<void>(error_code::file_write_failed, "Failed to replace with symlink",
+                         link.string());
+    }
+    return Ok();
+}
+
+// Same "<hash> <name>" format as the seed manifest, hash in hex.
+std::map<std::string, uint64_t> read_manifest(const fs::path &dir)
+{
+    std::map<std::string, uint64_t> manifest;
+    std::ifstream in(dir / MANIFEST_NAME);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        auto space = line.find(' ');
+        if (space == std::string::npos)
+            continue;
+        try
+        {
+            manifest[line.substr(space + 1)] = std::stoull(line.substr(0, space), nullptr, 16);
+        }
+        catch (const std::exception &)
+        {
+        }
+    }
+    return manifest;
+}
+
+Result<void> write_manifest(const fs::path &dir, const std::map<std::string, uint64_t> &manifest)
+{
+    std::string data;
+    char hash[17];
+    for (const auto &[name, value] : manifest)
+    {
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(value));
+        data += std::string(hash) + " " + name + "\n";
+    }
+    return write_atomically(dir / MANIFEST_NAME, data);
+}
+} // namespace
+
+bundle_store::bundle_store(std::filesystem::path root) : m_root(std::move(root))
+{
+}
+
+std::filesystem::path bundle_store::default_root()
+{
+    return config::instance().get_user_state_dir() / "bundles";
+}
+
+const std::filesystem::path &bundle_store::root() const
+{
+    return m_root;
+}
+
+std::string bundle_store::dir_name(const std::string &palette_name)
+{
+    // Percent-encoding rather than replacing keeps distinct names in distinct directories.
+    // A leading '_' is escaped so that "_" is free to stand for the empty name.
+    if (palette_name.empty())
+        return "_";
+    if (palette_name == CURRENT_LINK)
+        return "%63urrent";
+
+    const std::string_view temp_suffix = ".tmp";
+    const size_t temp_dot = palette_name.size() > temp_suffix.size() &&
+                                    palette_name.ends_with(temp_suffix)
+                                ? palette_name.size() - temp_suffix.size()
+                                : std::string::npos;
+    std::string name;
+    char escaped[4];
+    for (size_t i = 0; i < palette_name.size(); ++i)
+    {
+        const char c = palette_name[i];
+        if (c == '/' || c == '\\' || c == '%' || (i == 0 && (c == '.' || c == '_')) ||
+            i == temp_dot)
+        {
+            std::snprintf(escaped, sizeof(escaped), "%%%02X", static_cast<unsigned char>(c));
+            name += escaped;
+        }
+        else
+        {
+            name += c;
+        }
+    }
+    return name;
+}
+
+std::string bundle_store::entry_name(const std::string &template_name)
+{
+    // The same rules keep entries apart from the manifest and the temp files.
+    return dir_name(template_name);
+}
+
+Result<size_t> bundle_store::build(const palette &pal,
+                                   const std::vector<theme_template *> &templates)
+{
+    trace::scope build_scope("bundle.build", pal.name());
+    const fs::path dir = m_root / dir_name(pal.name());
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return Err<size_t>(error_code::dir_create_failed, ec.message(), dir.string());
+
+    auto manifest = read_manifest(dir);
+    const uint64_t colors = render_cache::palette_hash(pal);
+    size_t rendered = 0;
+
+    for (auto *tmpl : templates)
+    {
+        auto loaded = tmpl->load_template();
+        if (!loaded)
+            return Err<size_t>(loaded.error());
+
+        const std::string entry = entry_name(tmpl->name());
+        const uint64_t hash = render_cache::key(*tmpl, colors);
+        auto it = manifest.find(entry);
+        if (it != manifest.end() && it->second == hash && fs::exists(dir / entry, ec))
+            continue;
+
+        trace::scope render_scope("bundle.render", tmpl->name());
+        tmpl->apply_palette(pal);
+        auto written = write_atomically(dir / entry, tmpl->processed_template());
+        if (!written)
+            return Err<size_t>(written.error());
+        manifest[entry] = hash;
+        ++rendered;
+    }
+
+    if (rendered > 0)
+    {
+        auto written = write_manifest(dir, manifest);
+        if (!written)
+            return Err<size_t>(written.error());
+    }
+    return Ok(rendered);
+}
+
+Result<void> bundle_store::activate(const std::string &palette_name)
+{
+    const std::string name = dir_name(palette_name);
+    std::error_code ec;
+    if (!fs::is_directory(m_root / name, ec))
+        return Err<void>(error_code::file_not_found, "Bundle has not been built", palette_name);
+    if (active() == name)
+        return Ok();
+    // Relative, so the link survives the state directory moving.
+    return replace_symlink(name, m_root / CURRENT_LINK);
+}
+
+std::string bundle_store::active() const
+{
+    std::error_code ec;
+    fs::path target = fs::read_symlink(m_root / CURRENT_LINK, ec);
+    if (ec)
+        return {};
+    return target.filename().string();
+}
+
+Result<void> bundle_store::link_output(const theme_template &tmpl) const
+{
+    const fs::path link = link_location(tmpl.output_path());
+    const fs::path target = m_root / CURRENT_LINK / entry_name(tmpl.name());
+
+    std::error_code ec;
+    if (fs::is_symlink(link, ec) && fs::read_symlink(link, ec) == target)
+        return Ok();
+
+    fs::create_directories(link.parent_path(), ec);
+    if (ec)
+        return Err<void>(error_code::dir_create_failed, ec.message(), link.string());
+    return replace_symlink(target, link);
+}
+
+void bundle_store::unlink_output(const theme_template &tmpl) const
+{
+    const fs::path link = link_location(tmpl.output_path());
+    std::error_code ec;
+    if (!fs::is_symlink(link, ec))
+        return;
+    fs::path target = fs::read_symlink(link, ec);
+    if (!ec && inside_root(target.is_relative() ? link.parent_path() / target : target))
+        fs::remove(link, ec);
+}
+
+void bundle_store::prune(const std::vector<std::string> &keep) const
+{
+    std::unordered_set<std::string> kept{active()};
+    for (const auto &name : keep)
+        kept.insert(dir_name(name));
+
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(m_root, ec))
+    {
+        const std::string name = entry.path().filename().string();
+        if (name == CURRENT_LINK || name[0] == '.' || kept.count(name) ||
+            !entry.is_directory(ec) || entry.is_symlink(ec))
+            continue;
+        fs::remove_all(entry.path(), ec);
+    }
+}
+
+bool bundle_store::inside_root(const std::filesystem::path &path) const
+{
+    auto relative = path.lexically_normal().lexically_relative(m_root.lexically_normal());
+    return !relative.empty() && *relative.begin() != "..";
+}
+
+std::filesystem::path bundle_store::link_location(const std::filesystem::path &output) const
+{
+    // Follow symlinks that are not ours, bounded like the kernel's own resolution.
+    fs::path path = output;
+    for (int hops = 0; hops < 40; ++hops)
+    {
+        std::error_code ec;
+        if (!fs::is_symlink(path, ec))
+            break;
+        fs::path target = fs::read_symlink(path, ec);
+        if (ec)
+            break;
+        if (target.is_relative())
+            target = path.parent_path() / target;
+        if (inside_root(target))
+            break;
+        path = target.lexically_normal();
+    }
+    return path;
+}
+} // namespace clrsync::core
@@ -0,0 +1,68 @@
+#ifndef CLRSYNC_CORE_THEME_BUNDLE_STORE_HPP
+#define CLRSYNC_CORE_THEME_BUNDLE_STORE_HPP
+
+#include "core/common/error.hpp"
+#include "core/palette/palette.hpp"
+#include "core/theme/theme_template.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace clrsync::core
+{
+// Pre-rendered outputs, one directory per palette:
+//
+//   <root>/<palette>/<template>    rendered output
+//   <root>/<palette>/.manifest     "<hash> <template>" of the inputs each output came from
+//   <root>/current -> <palette>    the active bundle
+//
+// Every template's output path is a symlink to <root>/current/<template>, so switching
+// palettes is a single rename() of `current`, however many templates there are.
+class bundle_store
+{
+  public:
+    bundle_store() = default;
+    explicit bundle_store(std::filesystem::path root);
+
+    // <state dir>/bundles
+    static std::filesystem::path default_root();
+
+    const std::filesystem::path &root() const;
+
+    // Directory name for a palette: '/', '\\' and '%' are percent-encoded, as are a leading '.'
+    // or '_' and the dot of a ".tmp" suffix, so it is never hidden, "current" or a temp file,
+    // and distinct palettes never share a directory.
+    static std::string dir_name(const std::string &palette_name);
+
+    // Renders the templates whose palette or template content changed since the bundle was
+    // last built and returns how many were rendered. May throw like apply_palette().
+    Result<size_t> build(const palette &pal, const std::vector<theme_template *> &templates);
+
+    // Atomically points `current` at the palette's bundle.
+    Result<void> activate(const std::string &palette_name);
+
+    // Palette directory `current` points at, or empty if none is active.
+    std::string active() const;
+
+    // Makes the template's output a symlink into `current`. An output that is itself a
+    // symlink (dotfile managers) is followed, and the file it ends at is linked instead.
+    Result<void> link_output(const theme_template &tmpl) const;
+
+    // Removes the output's link into the bundles, so a direct render writes a regular file
+    // instead of into a bundle.
+    void unlink_output(const theme_template &tmpl) const;
+
+    // Deletes every bundle except those for `keep` and the active one.
+    void prune(const std::vector<std::string> &keep) const;
+
+  private:
+    std::filesystem::path m_root{};
+
+    static std::string entry_name(const std::string &template_name);
+    bool inside_root(const std::filesystem::path &path) const;
+    std::filesystem::path link_location(const std::filesystem::path &output) const;
+};
+} // namespace clrsync::core
+
+#endif // CLRSYNC_CORE_THEME_BUNDLE_STORE_HPP
@@ -0,0 +1,225 @@
+#include "render_cache.hpp"
+#include "core/common/trace.hpp"
+#include "core/common/utils.hpp"
+#include "core/config/config.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace clrsync::core
+{
+namespace
+{
+namespace fs = std::filesystem;
+
+#ifdef __linux__
+bool copy_fd(int in, int out)
+{
+    char buffer[64 * 1024];
+    for (;;)
+    {
+        ssize_t n = ::read(in, buffer, sizeof(buffer));
+        if (n == 0)
+            return true;
+        if (n < 0)
+            return false;
+        for (ssize_t done = 0; done < n;)
+        {
+            ssize_t written = ::write(out, buffer + done, static_cast<size_t>(n - done));
+            if (written < 0)
+                return false;
+            done += written;
+        }
+    }
+}
+#endif
+
+// Writes `src` over `dst` in place, so permissions and symlinks at `dst` behave exactly as
+// with theme_template::save_output(). On Btrfs and XFS the data is shared, not copied.
+bool clone_file(const fs::path &src, const fs::path &dst)
+{
+#ifdef __linux__
+    int in = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+        return false;
+    int out = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0)
+    {
+        ::close(in);
+        return false;
+    }
+    bool ok = ::ioctl(out, FICLONE, in) == 0 || copy_fd(in, out);
+    ::close(in);
+    return ::close(out) == 0 && ok;
+#else
+    std::ifstream in(src, std::ios::binary);
+    if (!in)
+        return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream out(dst, std::ios::binary | std::ios::trunc);
+    out << data;
+    return static_cast<bool>(out);
+#endif
+}
+
+bool parse_key(const std::string &name, uint64_t &key)
+{
+    auto hex = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; };
+    if (name.size() != 16 || !std::all_of(name.begin(), name.end(), hex))
+        return false;
+    key = std::stoull(name, nullptr, 16);
+    return true;
+}
+} // namespace
+
+render_cache::render_cache(std::filesystem::path root, uint64_t max_bytes)
+    : m_root(std::move(root)), m_max_bytes(max_bytes)
+{
+}
+
+std::filesystem::path render_cache::default_root()
+{
+    return config::instance().get_user_state_dir() / "render-cache";
+}
+
+uint64_t render_cache::palette_hash(const palette &pal)
+{
+    std::vector<std::pair<std::string, uint32_t>> colors;
+    colors.reserve(pal.colors().size());
+    for (const auto &[key, color] : pal.colors())
+        colors.emplace_back(key, color.hex());
+    std::sort(colors.begin(), colors.end());
+
+    uint64_t hash = fnv1a64("");
+    for (const auto &[key, value] : colors)
+    {
+        hash = fnv1a64(key, hash);
+        hash = fnv1a64(std::string_view(reinterpret_cast<const char *>(&value), sizeof(value)),
+                       hash);
+    }
+    return hash;
+}
+
+uint64_t render_cache::key(const theme_template &tmpl, uint64_t palette_hash)
+{
+    const uint64_t content = tmpl.content_hash();
+    return fnv1a64(std::string_view(reinterpret_cast<const char *>(&content), sizeof(content)),
+                   palette_hash);
+}
+
+bool render_cache::restore(uint64_t key, const std::filesystem::path &output)
+{
+    if (!enabled())
+        return false;
+    load_index();
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        trace::count("render_cache.misses");
+        return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(output.parent_path(), ec);
+    const fs::path path = entry_path(key);
+    if (!clone_file(path, output))
+    {
+        // Evicted by another process, or unreadable: render instead.
+        m_total_bytes -= it->second.size;
+        m_entries.erase(it);
+        trace::count("render_cache.misses");
+        return false;
+    }
+
+    it->second.last_use = fs::file_time_type::clock::now();
+    fs::last_write_time(path, it->second.last_use, ec);
+    trace::count("render_cache.hits");
+    trace::count("render_cache.bytes_saved", static_cast<int64_t>(it->second.size));
+    return true;
+}
+
+void render_cache::store(uint64_t key, const std::string &data)
+{
+    if (!enabled() || data.size() > m_max_bytes)
+        return;
+    load_index();
+
+    const fs::path path = entry_path(key);
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out << data;
+        if (!out)
+            return;
+    }
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec)
+    {
+        fs::remove(temp, ec);
+        return;
+    }
+
+    auto &slot = m_entries[key];
+    m_total_bytes = m_total_bytes - slot.size + data.size();
+    slot.size = data.size();
+    slot.last_use = fs::file_time_type::clock::now();
+    evict();
+}
+
+std::filesystem::path render_cache::entry_path(uint64_t key) const
+{
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return m_root / name;
+}
+
+void render_cache::load_index()
+{
+    if (m_indexed)
+        return;
+    m_indexed = true;
+
+    std::error_code ec;
+    fs::create_directories(m_root, ec);
+    for (const auto &file : fs::directory_iterator(m_root, ec))
+    {
+        uint64_t key = 0;
+        if (!file.is_regular_file(ec) || !parse_key(file.path().filename().string(), key))
+            continue;
+        entry e;
+        e.size = file.file_size(ec);
+        e.last_use = file.last_write_time(ec);
+        m_entries[key] = e;
+        m_total_bytes += e.size;
+    }
+    // The bound may have shrunk since the entries were written.
+    evict();
+}
+
+void render_cache::evict()
+{
+    while (m_total_bytes > m_max_bytes && !m_entries.empty())
+    {
+        auto oldest = std::min_element(
+            m_entries.begin(), m_entries.end(),
+            [](const auto &a, const auto &b) { return a.second.last_use < b.second.last_use; });
+        std::error_code ec;
+        fs::remove(entry_path(oldest->first), ec);
+        m_total_bytes -= oldest->second.size;
+        m_entries.erase(oldest);
+        trace::count("render_cache.evictions");
+    }
+}
+} // namespace clrsync::core
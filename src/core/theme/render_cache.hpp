@@ -0,0 +1,62 @@
+#ifndef CLRSYNC_CORE_THEME_RENDER_CACHE_HPP
+#define CLRSYNC_CORE_THEME_RENDER_CACHE_HPP
+
+#include "core/palette/palette.hpp"
+#include "core/theme/theme_template.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace clrsync::core
+{
+// Rendered outputs on disk, one file per (template content, palette colors) pair, so
+// switching back to a recently used theme copies bytes instead of rendering. Bounded by
+// total size; the least recently used entries go first. Recency is the entry's mtime, so
+// it carries over between runs of the CLI.
+class render_cache
+{
+  public:
+    render_cache() = default;
+    // A max_bytes of 0 disables the cache.
+    render_cache(std::filesystem::path root, uint64_t max_bytes);
+
+    // <state dir>/render-cache
+    static std::filesystem::path default_root();
+
+    bool enabled() const
+    {
+        return m_max_bytes > 0;
+    }
+
+    // Order-independent hash of the palette's colors.
+    static uint64_t palette_hash(const palette &pal);
+    // Identifies the output of rendering the loaded template with the palette.
+    static uint64_t key(const theme_template &tmpl, uint64_t palette_hash);
+
+    // Writes the cached output for `key` to `output`, cloning the file where the filesystem
+    // supports it. Returns false on a miss or if the output could not be written.
+    bool restore(uint64_t key, const std::filesystem::path &output);
+
+    void store(uint64_t key, const std::string &data);
+
+  private:
+    struct entry
+    {
+        uint64_t size{0};
+        std::filesystem::file_time_type last_use{};
+    };
+
+    std::filesystem::path m_root{};
+    uint64_t m_max_bytes{0};
+    bool m_indexed{false};
+    std::unordered_map<uint64_t, entry> m_entries{};
+    uint64_t m_total_bytes{0};
+
+    std::filesystem::path entry_path(uint64_t key) const;
+    void load_index();
+    void evict();
+};
+} // namespace clrsync::core
+
+#endif // CLRSYNC_CORE_THEME_RENDER_CACHE_HPP
@@ -0,0 +1,51 @@
+#include "template_filter.hpp"
+
+#include <algorithm>
+
+namespace clrsync::core
+{
+namespace
+{
+std::vector<std::string> split_list(const std::string &list)
+{
+    std::vector<std::string> items;
+    size_t pos = 0;
+    while (pos <= list.size())
+    {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos)
+            end = list.size();
+
+        size_t first = list.find_first_not_of(" \t", pos);
+        size_t last = list.find_last_not_of(" \t", end == 0 ? 0 : end - 1);
+        if (first != std::string::npos && first < end && last >= first)
+            items.push_back(list.substr(first, last - first + 1));
+        pos = end + 1;
+    }
+    return items;
+}
+
+bool selects(const std::vector<std::string> &entries, const theme_template &tmpl)
+{
+    return std::any_of(entries.begin(), entries.end(), [&tmpl](const std::string &entry) {
+        const auto &tags = tmpl.tags();
+        return entry == tmpl.name() || std::find(tags.begin(), tags.end(), entry) != tags.end();
+    });
+}
+} // namespace
+
+template_filter template_filter::from_lists(const std::string &only, const std::string &except)
+{
+    template_filter filter;
+    filter.only = split_list(only);
+    filter.except = split_list(except);
+    return filter;
+}
+
+bool template_filter::matches(const theme_template &tmpl) const
+{
+    if (!only.empty() && !selects(only, tmpl))
+        return false;
+    return !selects(except, tmpl);
+}
+} // namespace clrsync::core
@@ -0,0 +1,29 @@
+#ifndef CLRSYNC_CORE_THEME_TEMPLATE_FILTER_HPP
+#define CLRSYNC_CORE_THEME_TEMPLATE_FILTER_HPP
+
+#include "core/theme/theme_template.hpp"
+#include <string>
+#include <vector>
+
+namespace clrsync::core
+{
+// Chooses which templates an apply touches. Entries match a template's name or any of its
+// tags; an empty `only` list selects every template.
+struct template_filter
+{
+    std::vector<std::string> only{};
+    std::vector<std::string> except{};
+
+    // Builds a filter from comma-separated lists such as "kitty,nvim".
+    static template_filter from_lists(const std::string &only, const std::string &except);
+
+    bool empty() const
+    {
+        return only.empty() && except.empty();
+    }
+
+    bool matches(const theme_template &tmpl) const;
+};
+} // namespace clrsync::core
+
+#endif // CLRSYNC_CORE_THEME_TEMPLATE_FILTER_HPP
@@ -2,9 +2,11 @@
 #define CLRSYNC_CORE_THEME_TEMPLATE_MANAGER_HPP
 
 #include "core/config/config.hpp"
+#include "core/theme/template_filter.hpp"
 #include "core/theme/theme_template.hpp"
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace clrsync::core
 {
@@ -13,19 +15,44 @@ template <typename FileType> class template_manager
 {
   public:
     template_manager() = default;
+    // Works on these templates for good instead of following the config, so it may be used
+    // off the thread that owns the config.
+    explicit template_manager(std::unordered_map<std::string, theme_template> templates)
+        : m_templates(std::move(templates)), m_fixed(true)
+    {
+    }
+    // Re-synced from config only when its generation moves. Copies are cheap: loaded
+    // content is shared, not duplicated.
     std::unordered_map<std::string, theme_template> &templates()
     {
-        auto themes = config::instance().templates();
-        m_templates.clear();
-        for (const auto &t : themes)
+        auto &cfg = config::instance();
+        if (m_fixed || (m_synced && m_generation == cfg.generation()))
+            return m_templates;
+
+        m_templates = cfg.templates();
+        m_generation = cfg.generation();
+        m_synced = true;
+        return m_templates;
+    }
+
+    // Enabled templates accepted by `filter`. Works on metadata only, so templates that are
+    // filtered out are never opened.
+    std::vector<theme_template *> select(const template_filter &filter)
+    {
+        std::vector<theme_template *> selected;
+        for (auto &[name, tmpl] : templates())
         {
-            m_templates.insert({t.first, t.second});
+            if (tmpl.enabled() && filter.matches(tmpl))
+                selected.push_back(&tmpl);
         }
-        return m_templates;
+        return selected;
     }
 
   private:
     std::unordered_map<std::string, theme_template> m_templates{};
+    uint64_t m_generation{0};
+    bool m_synced{false};
+    bool m_fixed{false};
 };
 
 } // namespace clrsync::core
@@ -1,8 +1,11 @@
 #ifndef CLRSYNC_CORE_THEME_THEME_RENDERER_HPP
 #define CLRSYNC_CORE_THEME_THEME_RENDERER_HPP
 #include "core/common/error.hpp"
+#include "core/common/trace.hpp"
 #include "core/config/config.hpp"
 #include "core/palette/palette_manager.hpp"
+#include "core/theme/bundle_store.hpp"
+#include "core/theme/render_cache.hpp"
 #include "core/theme/template_manager.hpp"
 #include <iostream>
 #include <string>
@@ -13,59 +16,233 @@ namespace clrsync::core
 template <typename FileType> class theme_renderer
 {
   public:
+    // Settings are read from the config once; build a new renderer after it changes.
     theme_renderer()
     {
         auto &cfg = config::instance();
+        auto snap = cfg.snapshot();
         m_pal_manager.load_palettes_from_directory(cfg.palettes_path());
         m_template_manager = template_manager<FileType>();
+        m_bundles = bundle_store(bundle_store::default_root());
+        m_cache = render_cache(render_cache::default_root(),
+                               static_cast<uint64_t>(snap->render_cache_mb) << 20);
+        m_bundles_enabled = snap->bundles;
     }
 
-    Result<void> apply_theme(const std::string &theme_name)
+    // Renders these templates with the given settings and never touches the config, so it can
+    // run on a worker thread: pass palettes to apply_palette_to_all_templates() rather than by
+    // name. build_bundles() needs the default constructor.
+    theme_renderer(std::unordered_map<std::string, theme_template> templates,
+                   uint32_t render_cache_mb, bool bundles)
+        : m_template_manager(std::move(templates)), m_bundles(bundle_store::default_root()),
+          m_cache(render_cache::default_root(), static_cast<uint64_t>(render_cache_mb) << 20),
+          m_bundles_enabled(bundles)
+    {
+    }
+
+    Result<void> apply_theme(const std::string &theme_name, const template_filter &filter = {})
     {
         auto palette = m_pal_manager.get_palette(theme_name);
         if (!palette)
             return Err<void>(error_code::palette_not_found, "Palette not found", theme_name);
-        return apply_palette_to_all_templates(*palette);
+        return apply_palette_to_all_templates(*palette, filter);
     }
 
-    Result<void> apply_theme_from_path(const std::string &path)
+    Result<void> apply_theme_from_path(const std::string &path,
+                                       const template_filter &filter = {})
     {
         auto palette = m_pal_manager.load_palette_from_file(path);
-        return apply_palette_to_all_templates(palette);
+        return apply_palette_to_all_templates(palette, filter);
+    }
+
+    Result<void> apply_palette_to_all_templates(const palette &pal,
+                                                const template_filter &filter = {})
+    {
+        trace::scope apply_scope("apply", pal.name());
+        auto selected = m_template_manager.select(filter);
+        // Switching `current` moves every linked output at once, so a filtered apply
+        // renders its templates directly instead.
+        if (bundles_enabled() && filter.empty())
+            return apply_bundle(pal, selected, selected);
+
+        for (auto *tmpl : selected)
+        {
+            auto result = render_template(*tmpl, pal);
+            if (!result)
+                return result;
+        }
+        return Ok();
+    }
+
+    Result<void> apply_palette_to_template(const palette &pal, const std::string &template_name)
+    {
+        auto &templates = m_template_manager.templates();
+        auto it = templates.find(template_name);
+        if (it == templates.end())
+            return Err<void>(error_code::template_not_found, "Template not found", template_name);
+        if (!it->second.enabled())
+            return Ok();
+        if (bundles_enabled())
+            return apply_bundle(pal, m_template_manager.select({}), {&it->second});
+        return render_template(it->second, pal);
+    }
+
+    // Brings the bundles of the pinned palettes (all palettes when none are pinned) up to
+    // date, rendering only outputs whose palette or template changed, and drops bundles of
+    // palettes that are gone. Returns the number of outputs rendered.
+    Result<size_t> build_bundles()
+    {
+        if (!bundles_enabled())
+            return Ok<size_t>(0);
+
+        std::vector<const palette *> palettes;
+        const auto pinned = config::instance().snapshot()->bundle_palettes;
+        if (pinned.empty())
+        {
+            for (const auto &[name, pal] : m_pal_manager.palettes())
+                palettes.push_back(pal.get());
+        }
+        for (const auto &name : pinned)
+        {
+            if (const auto *pal = m_pal_manager.get_palette(name))
+                palettes.push_back(pal);
+            else
+                std::cerr << "Warning: pinned palette " << name << " not found\n";
+        }
+
+        auto templates = m_template_manager.select({});
+        std::vector<std::string> built;
+        size_t rendered = 0;
+        for (const auto *pal : palettes)
+        {
+            auto result = m_bundles.build(*pal, templates);
+            if (!result)
+                return result;
+            rendered += result.value();
+            built.push_back(pal->name());
+        }
+        m_bundles.prune(built);
+        return Ok(rendered);
+    }
+
+    // Picks up added, changed and removed palette files since the last scan.
+    void reload_palettes()
+    {
+        m_pal_manager.load_palettes_from_directory(config::instance().palettes_path());
+    }
+
+    // Loads the selected templates now, so later applies only re-read files that changed.
+    void preload_templates(const template_filter &filter = {})
+    {
+        for (auto *tmpl : m_template_manager.select(filter))
+            (void)tmpl->load_template();
+    }
+
+    const palette *get_palette(const std::string &name) const
+    {
+        return m_pal_manager.get_palette(name);
     }
 
   private:
     palette_manager<FileType> m_pal_manager;
     template_manager<FileType> m_template_manager;
+    bundle_store m_bundles;
+    render_cache m_cache;
+    bool m_bundles_enabled{false};
 
-    Result<void> apply_palette_to_all_templates(const palette &pal)
+    bool bundles_enabled() const
     {
-        for (auto &t_pair : m_template_manager.templates())
+        return m_bundles_enabled;
+    }
+
+    // Brings the palette's bundle up to date for `templates`, links their outputs into it,
+    // switches to it and runs the reload commands of `reload`.
+    Result<void> apply_bundle(const palette &pal, const std::vector<theme_template *> &templates,
+                              const std::vector<theme_template *> &reload)
+    {
+        auto built = m_bundles.build(pal, templates);
+        if (!built)
+            return Err<void>(built.error());
+
+        for (const auto *tmpl : templates)
+        {
+            auto linked = m_bundles.link_output(*tmpl);
+            if (!linked)
+                return linked;
+        }
+
+        {
+            trace::scope stage("bundle.switch", pal.name());
+            auto switched = m_bundles.activate(pal.name());
+            if (!switched)
+                return switched;
+        }
+
+        for (const auto *tmpl : reload)
+            run_reload_command(*tmpl);
+        return Ok();
+    }
+
+    static void run_reload_command(const theme_template &tmpl)
+    {
+        if (tmpl.reload_command().empty())
+            return;
+
+        trace::scope stage("template.reload_cmd", tmpl.reload_command());
+        int result = std::system(tmpl.reload_command().c_str());
+        if (result != 0)
+        {
+            std::cerr << "Warning: Command " << tmpl.reload_command() << " failed with code "
+                      << result << "\n";
+        }
+    }
+
+    Result<void> render_template(theme_template &tmpl, const palette &pal)
+    {
+        trace::scope template_scope("template", tmpl.name());
+
+        Result<void> load_result = Ok();
         {
-            auto &tmpl = t_pair.second;
-            if (!tmpl.enabled())
-                continue;
+            trace::scope stage("template.load", tmpl.template_path());
+            load_result = tmpl.load_template();
+        }
+        if (!load_result)
+            return load_result;
 
-            auto load_result = tmpl.load_template();
-            if (!load_result)
-                return load_result;
+        // Never write through a link into a bundle: that would change the bundle itself.
+        m_bundles.unlink_output(tmpl);
+
+        uint64_t cache_key = 0;
+        bool restored = false;
+        if (m_cache.enabled())
+        {
+            trace::scope stage("template.cache", tmpl.output_path());
+            cache_key = render_cache::key(tmpl, render_cache::palette_hash(pal));
+            restored = m_cache.restore(cache_key, tmpl.output_path());
+        }
+        if (restored)
+        {
+            run_reload_command(tmpl);
+            return Ok();
+        }
 
+        {
+            trace::scope stage("template.render");
             tmpl.apply_palette(pal);
+        }
 
-            auto save_result = tmpl.save_output();
-            if (!save_result)
-                return save_result;
-
-            if (!tmpl.reload_command().empty())
-            {
-                int result = std::system(tmpl.reload_command().c_str());
-                if (result != 0)
-                {
-                    std::cerr << "Warning: Command " << tmpl.reload_command()
-                              << " failed with code " << result << "\n";
-                }
-            }
+        Result<void> save_result = Ok();
+        {
+            trace::scope stage("template.write", tmpl.output_path());
+            save_result = tmpl.save_output();
         }
+        if (!save_result)
+            return save_result;
+
+        if (m_cache.enabled())
+            m_cache.store(cache_key, tmpl.processed_template());
+
+        run_reload_command(tmpl);
         return Ok();
     }
 };
@@ -3,6 +3,9 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace clrsync::core
 {
@@ -31,6 +34,7 @@ const std::string &theme_template::template_path() const
 void theme_template::set_template_path(const std::string &path)
 {
     m_template_path = normalize_path(path).string();
+    m_content.reset();
 }
 
 const std::string &theme_template::output_path() const
@@ -45,50 +49,190 @@ void theme_template::set_output_path(const std::string &path)
 
 Result<void> theme_template::load_template()
 {
-    if (!std::filesystem::exists(m_template_path))
+    io::file_stamp stamp;
+    if (!io::read_file_stamp(m_template_path, stamp))
     {
         return Err<void>(error_code::template_not_found, "Template file is missing",
                          m_template_path);
     }
 
-    std::ifstream input(m_template_path, std::ios::binary);
+    if (m_content && m_content->stamp == stamp)
+        return Ok();
+
+    auto loaded = load_content(m_template_path, stamp);
+    if (!loaded)
+        return Err<void>(loaded.error());
+
+    m_content = std::move(loaded.value());
+    return Ok();
+}
+
+void theme_template::set_template_data(const std::string &data)
+{
+    auto loaded = std::make_shared<content>();
+    loaded->data = data;
+    loaded->segments = tokenize(loaded->data);
+    loaded->hash = fnv1a64(loaded->data);
+    m_content = std::move(loaded);
+}
+
+Result<std::shared_ptr<const theme_template::content>> theme_template::load_content(
+    const std::string &path, const io::file_stamp &stamp)
+{
+    // Only the theme_template instances own content; the cache just lets them find each
+    // other's, so a removed template or an outdated version is freed with its last user.
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, std::weak_ptr<const content>> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = cache.find(path);
+        if (it != cache.end())
+        {
+            auto cached = it->second.lock();
+            if (cached && cached->stamp == stamp)
+                return Ok(std::move(cached));
+        }
+    }
+
+    std::ifstream input(path, std::ios::binary);
     if (!input)
     {
-        return Err<void>(error_code::template_load_failed, "Failed to open template file",
-                         m_template_path);
+        return Err<std::shared_ptr<const content>>(error_code::template_load_failed,
+                                                   "Failed to open template file", path);
     }
 
-    m_template_data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
-    return Ok();
+    auto loaded = std::make_shared<content>();
+    loaded->data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    loaded->segments = tokenize(loaded->data);
+    loaded->hash = fnv1a64(loaded->data);
+    loaded->stamp = stamp;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    std::erase_if(cache, [](const auto &entry) { return entry.second.expired(); });
+    cache[path] = loaded;
+    return Ok(std::shared_ptr<const content>(std::move(loaded)));
 }
 
-void theme_template::apply_palette(const core::palette &palette)
+std::vector<theme_template::segment> theme_template::tokenize(const std::string &data)
 {
-    m_processed_data = m_template_data;
+    std::vector<segment> segments;
+    auto add_literal = [&segments](const std::string &data, size_t from, size_t to) {
+        if (from >= to)
+            return;
+        if (segments.empty() || segments.back().placeholder)
+            segments.push_back({});
+        segments.back().text.append(data, from, to - from);
+    };
 
-    for (const auto &[key, color] : palette.colors())
+    size_t pos = 0;
+    while (pos < data.size())
     {
-        // simple replacement: {foreground}
-        replace_all(m_processed_data, "{" + key + "}", color.format("hex"));
+        size_t open = data.find('{', pos);
+        if (open == std::string::npos)
+            break;
+
+        // The key runs up to the first '.', '}' or another '{'.
+        size_t key_end = data.find_first_of(".{}", open + 1);
+        if (key_end == std::string::npos)
+            break;
 
-        // mutli-component: {foreground.r}, {foreground.rgb}, etc.
-        std::string prefix = "{" + key + ".";
-        size_t pos = 0;
-        while ((pos = m_processed_data.find(prefix, pos)) != std::string::npos)
+        if (data[key_end] == '{' || key_end == open + 1)
         {
-            size_t end = m_processed_data.find('}', pos);
-            if (end == std::string::npos)
+            add_literal(data, pos, key_end);
+            pos = key_end;
+            continue;
+        }
+
+        size_t close = key_end;
+        if (data[key_end] == '.')
+        {
+            close = data.find('}', key_end + 1);
+            if (close == std::string::npos)
                 break;
 
-            const size_t field_start = pos + prefix.size();
-            std::string field = m_processed_data.substr(field_start, end - field_start);
+            // A '{' inside the field: consume only "{key." and resume at the nested brace. The
+            // field can never be a valid format, so rendering fails if the key exists.
+            size_t nested = data.find('{', key_end + 1);
+            if (nested < close)
+            {
+                add_literal(data, pos, open);
+                segment seg;
+                seg.placeholder = true;
+                seg.nested = true;
+                seg.text = data.substr(open, nested - open);
+                seg.key = data.substr(open + 1, key_end - open - 1);
+                seg.field = data.substr(key_end + 1, close - key_end - 1);
+                segments.push_back(std::move(seg));
+                pos = nested;
+                continue;
+            }
+        }
+
+        add_literal(data, pos, open);
+        segment seg;
+        seg.placeholder = true;
+        seg.text = data.substr(open, close - open + 1);
+        seg.key = data.substr(open + 1, key_end - open - 1);
+        if (close != key_end)
+        {
+            seg.has_field = true;
+            seg.field = data.substr(key_end + 1, close - key_end - 1);
+        }
+        segments.push_back(std::move(seg));
+        pos = close + 1;
+    }
+    add_literal(data, pos, data.size());
+    return segments;
+}
+
+void theme_template::apply_palette(const core::palette &palette)
+{
+    m_processed_data.clear();
+    render_into(palette, m_processed_data, nullptr);
+}
 
-            std::string value = color.format(field);
+void theme_template::render(const core::palette &palette, std::string &out,
+                            std::vector<substitution> &substitutions) const
+{
+    out.clear();
+    substitutions.clear();
+    render_into(palette, out, &substitutions);
+}
 
-            m_processed_data.replace(pos, end - pos + 1, value);
+void theme_template::render_into(const core::palette &palette, std::string &out,
+                                 std::vector<substitution> *substitutions) const
+{
+    if (!m_content)
+        return;
 
-            pos += value.size();
+    const auto &colors = palette.colors();
+    out.reserve(m_content->data.size() + m_content->data.size() / 4);
+
+    for (const auto &seg : m_content->segments)
+    {
+        if (!seg.placeholder)
+        {
+            out += seg.text;
+            continue;
         }
+
+        auto it = colors.find(seg.key);
+        if (it == colors.end())
+        {
+            out += seg.text;
+            continue;
+        }
+        if (seg.nested)
+            throw std::runtime_error("Unknown color format: " + seg.field);
+
+        const size_t offset = out.size();
+        if (!seg.has_field)
+            out += it->second.to_hex_string();
+        else
+            out += it->second.format(seg.field);
+        if (substitutions)
+            substitutions->push_back({offset, out.size() - offset, it->second.hex()});
     }
 }
 
@@ -122,25 +266,18 @@ Result<void> theme_template::save_output() const
 
 const std::string &theme_template::raw_template() const
 {
-    return m_template_data;
+    static const std::string empty;
+    return m_content ? m_content->data : empty;
 }
 
-const std::string &theme_template::processed_template() const
+uint64_t theme_template::content_hash() const
 {
-    return m_processed_data;
+    return m_content ? m_content->hash : fnv1a64("");
 }
 
-void theme_template::replace_all(std::string &str, const std::string &from, const std::string &to)
+const std::string &theme_template::processed_template() const
 {
-    if (from.empty())
-        return;
-
-    size_t pos = 0;
-    while ((pos = str.find(from, pos)) != std::string::npos)
-    {
-        str.replace(pos, from.length(), to);
-        pos += to.length();
-    }
+    return m_processed_data;
 }
 
 const std::string &theme_template::reload_command() const
@@ -163,4 +300,14 @@ void theme_template::set_enabled(bool enabled)
     m_enabled = enabled;
 }
 
+const std::vector<std::string> &theme_template::tags() const
+{
+    return m_tags;
+}
+
+void theme_template::set_tags(std::vector<std::string> tags)
+{
+    m_tags = std::move(tags);
+}
+
 } // namespace clrsync::core
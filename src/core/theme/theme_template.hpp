@@ -2,8 +2,12 @@
 #define clrsync_CORE_IO_THEME_TEMPLATE_HPP
 
 #include "core/common/error.hpp"
+#include "core/io/file_stamp.hpp"
 #include "core/palette/palette.hpp"
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace clrsync::core
 {
@@ -27,14 +31,36 @@ class theme_template
 
     void set_output_path(const std::string &path);
 
+    // Reads and tokenizes the template file on first use. Content is shared between copies
+    // and across templates with the same input file, and only re-read when its stamp changes.
     Result<void> load_template();
 
+    // Tokenizes text held in memory instead of the template file, e.g. an unsaved editor
+    // buffer. The next load_template() goes back to the file.
+    void set_template_data(const std::string &data);
+
     void apply_palette(const core::palette &palette);
 
+    // A substituted value in rendered text: where it starts, how long it is, and the color.
+    struct substitution
+    {
+        size_t offset{0};
+        size_t length{0};
+        uint32_t color{0};
+    };
+
+    // Renders like apply_palette(), into `out` instead of processed_template(), and records
+    // where each value went, e.g. for a preview that highlights them.
+    void render(const core::palette &palette, std::string &out,
+                std::vector<substitution> &substitutions) const;
+
     Result<void> save_output() const;
 
     const std::string &raw_template() const;
 
+    // FNV-1a of raw_template(), computed once per load.
+    uint64_t content_hash() const;
+
     const std::string &processed_template() const;
 
     const std::string &reload_command() const;
@@ -45,16 +71,47 @@ class theme_template
 
     void set_enabled(bool enabled);
 
+    // Free-form labels ("terminal", "editor", ...) used to select templates to apply.
+    const std::vector<std::string> &tags() const;
+
+    void set_tags(std::vector<std::string> tags);
+
   private:
+    // A template is split once into literal runs and {key} / {key.field} placeholders, so
+    // rendering is a single pass that never rescans the text.
+    struct segment
+    {
+        std::string text;
+        std::string key;
+        std::string field;
+        bool placeholder{false};
+        bool has_field{false};
+        // "{key." whose field runs into another '{': only the prefix is consumed here.
+        bool nested{false};
+    };
+
+    struct content
+    {
+        std::string data;
+        std::vector<segment> segments;
+        uint64_t hash{0};
+        io::file_stamp stamp;
+    };
+
     std::string m_name{};
     std::string m_template_path{};
     std::string m_output_path{};
     bool m_enabled = true;
-    std::string m_template_data{};
+    std::shared_ptr<const content> m_content{};
     std::string m_processed_data{};
     std::string m_reload_cmd{};
+    std::vector<std::string> m_tags{};
 
-    static void replace_all(std::string &str, const std::string &from, const std::string &to);
+    static std::vector<segment> tokenize(const std::string &data);
+    void render_into(const core::palette &palette, std::string &out,
+                     std::vector<substitution> *substitutions) const;
+    static Result<std::shared_ptr<const content>> load_content(const std::string &path,
+                                                               const io::file_stamp &stamp);
 };
 } // namespace clrsync::core
 
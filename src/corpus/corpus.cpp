@@ -0,0 +1,122 @@
+#include "corpus/corpus.hpp"
+
+#include <cmath>
+#include <fstream>
+
+#include "core/io/toml_file.hpp"
+#include "core/palette/color_keys.hpp"
+#include "core/palette/palette_manager.hpp"
+
+namespace clrsync::corpus
+{
+const std::vector<std::string> FORMAT_SPECIFIERS = {
+    "hex", "hex_stripped", "hexa", "hexa_stripped", "r",   "g",   "b",    "a",
+    "rgb", "rgba",         "h",    "s",             "l",   "hsl", "hsla", "hsla_a",
+};
+
+uint64_t rng::next()
+{
+    // splitmix64
+    uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+core::palette make_palette(const std::string &name, uint64_t seed)
+{
+    rng random(seed);
+    core::palette pal(name);
+    for (const auto &key : core::COLOR_KEYS)
+        pal.set_color(key, core::color(static_cast<uint32_t>(random.next()) | 0xFF));
+    return pal;
+}
+
+std::string make_template(const template_spec &spec, uint64_t seed)
+{
+    static const char *words[] = {"set", "color", "border", "font", "opacity", "option",
+                                  "enable", "cursor", "selection", "tab"};
+
+    rng random(seed);
+    std::string out;
+    size_t placeholders = 0;
+
+    auto placeholder = [&] {
+        out += '{';
+        out += core::COLOR_KEYS[random.below(core::NUM_COLOR_KEYS)];
+        // Walk the specifiers in order first so each one is covered.
+        if (placeholders < FORMAT_SPECIFIERS.size())
+            out += '.' + FORMAT_SPECIFIERS[placeholders];
+        else if (random.unit() < spec.format_ratio)
+            out += '.' + FORMAT_SPECIFIERS[random.below(FORMAT_SPECIFIERS.size())];
+        out += '}';
+        ++placeholders;
+    };
+
+    const double whole = std::floor(spec.density);
+    const double fraction = spec.density - whole;
+    for (size_t i = 0; i < spec.lines; ++i)
+    {
+        out += words[random.below(std::size(words))];
+        out += '_';
+        out += std::to_string(i);
+        out += " =";
+
+        size_t count = static_cast<size_t>(whole) + (random.unit() < fraction ? 1 : 0);
+        if (count == 0)
+            out += ' ' + std::to_string(random.next() % 1000);
+        for (size_t p = 0; p < count; ++p)
+        {
+            out += ' ';
+            placeholder();
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+void write_palettes(const std::filesystem::path &dir, size_t count, uint64_t seed)
+{
+    std::filesystem::create_directories(dir);
+    core::palette_manager<core::io::toml_file> manager;
+    for (size_t i = 0; i < count; ++i)
+        manager.save_palette_to_file(make_palette("palette-" + std::to_string(i), seed + i),
+                                     dir.string());
+}
+
+std::filesystem::path write_corpus(const std::filesystem::path &root, const corpus_spec &spec)
+{
+    const auto palettes_dir = root / "palettes";
+    write_palettes(palettes_dir, spec.palettes, spec.seed);
+
+    std::string config = "[general]\n"
+                         "palettes_path = '" +
+                         palettes_dir.generic_string() +
+                         "'\n"
+                         "default_theme = 'palette-0'\n"
+                         "font = 'JetBrainsMono Nerd Font Mono'\n"
+                         "font_size = 14\n";
+
+    for (size_t i = 0; i < spec.templates; ++i)
+    {
+        const auto name = "template-" + std::to_string(i);
+        const auto input = root / "templates" / (name + ".conf");
+        write_text_file(input, make_template(spec.tmpl, spec.seed * 7919 + i));
+
+        config += "\n[templates." + name + "]\n" + "input_path = '" + input.generic_string() +
+                  "'\n" + "output_path = '" + (root / "out" / (name + ".conf")).generic_string() +
+                  "'\n" + "enabled = true\n" + "reload_cmd = ''\n";
+    }
+
+    const auto config_path = root / "config.toml";
+    write_text_file(config_path, config);
+    return config_path;
+}
+
+void write_text_file(const std::filesystem::path &path, const std::string &data)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+}
+} // namespace clrsync::corpus
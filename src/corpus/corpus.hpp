@@ -0,0 +1,74 @@
+#ifndef CLRSYNC_CORPUS_CORPUS_HPP
+#define CLRSYNC_CORPUS_CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/palette/palette.hpp"
+
+// Deterministic synthetic inputs for benchmarks and scaling tests: the same seed always
+// yields the same palettes, templates and config, so timings stay comparable across runs
+// and machines.
+namespace clrsync::corpus
+{
+// Every specifier color::format() accepts.
+extern const std::vector<std::string> FORMAT_SPECIFIERS;
+
+class rng
+{
+  public:
+    explicit rng(uint64_t seed) : m_state(seed)
+    {
+    }
+    uint64_t next();
+    size_t below(size_t bound)
+    {
+        return static_cast<size_t>(next() % bound);
+    }
+    // Uniform in [0, 1).
+    double unit()
+    {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+  private:
+    uint64_t m_state;
+};
+
+struct template_spec
+{
+    size_t lines{200};
+    // Expected placeholders per line; fractional values mix lines with and without one.
+    double density{0.5};
+    // Share of placeholders that carry a .format specifier instead of the bare {key}.
+    double format_ratio{0.75};
+};
+
+struct corpus_spec
+{
+    size_t palettes{16};
+    size_t templates{4};
+    template_spec tmpl{};
+    uint64_t seed{1};
+};
+
+core::palette make_palette(const std::string &name, uint64_t seed);
+
+// Config-like text. Every format specifier appears at least once whenever the template has
+// room for that many placeholders.
+std::string make_template(const template_spec &spec, uint64_t seed);
+
+// Writes `count` palettes named palette-<n>.toml into `dir`.
+void write_palettes(const std::filesystem::path &dir, size_t count, uint64_t seed);
+
+// Writes palettes/, templates/ and a config.toml wiring them up (outputs go to out/).
+// Returns the config path.
+std::filesystem::path write_corpus(const std::filesystem::path &root, const corpus_spec &spec);
+
+void write_text_file(const std::filesystem::path &path, const std::string &data);
+} // namespace clrsync::corpus
+
+#endif // CLRSYNC_CORPUS_CORPUS_HPP
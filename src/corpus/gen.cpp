@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <argparse/argparse.hpp>
+
+#include "core/common/version.hpp"
+#include "corpus/corpus.hpp"
+
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("clrsync_gen", clrsync::core::version_string());
+    program.add_description("Writes a deterministic palette/template corpus and a config.toml "
+                            "that applies it, for benchmarks and scaling tests.");
+
+    program.add_argument("-o", "--out").required().help("output directory").metavar("DIR");
+    program.add_argument("-p", "--palettes")
+        .default_value(16)
+        .scan<'i', int>()
+        .help("number of palettes")
+        .metavar("N");
+    program.add_argument("-t", "--templates")
+        .default_value(4)
+        .scan<'i', int>()
+        .help("number of templates")
+        .metavar("N");
+    program.add_argument("-l", "--lines")
+        .default_value(200)
+        .scan<'i', int>()
+        .help("lines per template")
+        .metavar("N");
+    program.add_argument("-d", "--density")
+        .default_value(0.5)
+        .scan<'g', double>()
+        .help("placeholders per template line")
+        .metavar("X");
+    program.add_argument("--format-ratio")
+        .default_value(0.75)
+        .scan<'g', double>()
+        .help("share of placeholders using a .format specifier")
+        .metavar("X");
+    program.add_argument("-s", "--seed").default_value(1).scan<'i', int>().help("random seed");
+
+    try
+    {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::exception &err)
+    {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        return 1;
+    }
+
+    clrsync::corpus::corpus_spec spec;
+    spec.palettes = static_cast<size_t>(std::max(0, program.get<int>("--palettes")));
+    spec.templates = static_cast<size_t>(std::max(0, program.get<int>("--templates")));
+    spec.tmpl.lines = static_cast<size_t>(std::max(0, program.get<int>("--lines")));
+    spec.tmpl.density = std::max(0.0, program.get<double>("--density"));
+    spec.tmpl.format_ratio = program.get<double>("--format-ratio");
+    spec.seed = static_cast<uint64_t>(program.get<int>("--seed"));
+
+    try
+    {
+        auto config_path = clrsync::corpus::write_corpus(program.get<std::string>("--out"), spec);
+        std::cout << "Wrote " << spec.palettes << " palettes and " << spec.templates
+                  << " templates; apply with:" << std::endl
+                  << "  clrsync_cli --config " << config_path.string() << " --apply" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Failed to write corpus: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Fuzzes color::from_hex_string: exactly the "#RRGGBB" and "#RRGGBBAA" forms parse, they
+// round-trip through to_hex_string_with_alpha, and every format specifier renders them.
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "core/palette/color.hpp"
+#include "fuzz_input.hpp"
+
+using namespace clrsync;
+
+namespace
+{
+const char *const FORMATS[] = {"hex", "hex_stripped", "hexa", "hexa_stripped", "r",   "g",
+                               "b",   "a",            "rgb",  "rgba",          "h",   "s",
+                               "l",   "hsla_a",       "hsl",  "hsla"};
+
+bool well_formed(const std::string &text)
+{
+    if ((text.size() != 7 && text.size() != 9) || text[0] != '#')
+        return false;
+    for (size_t i = 1; i < text.size(); ++i)
+    {
+        if (!std::isxdigit(static_cast<unsigned char>(text[i])))
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    const std::string text(reinterpret_cast<const char *>(data), size);
+    const bool expect_ok = well_formed(text);
+
+    core::color color;
+    try
+    {
+        color.from_hex_string(text);
+    }
+    catch (const std::invalid_argument &)
+    {
+        if (expect_ok)
+            fuzz::fail("well-formed hex rejected", text);
+        return 0;
+    }
+
+    if (!expect_ok)
+        fuzz::fail("malformed hex accepted", text);
+
+    std::string expected = text;
+    for (char &c : expected)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    if (expected.size() == 7)
+        expected += "FF";
+    if (color.to_hex_string_with_alpha() != expected)
+        fuzz::fail("hex does not round-trip", text + " -> " + color.to_hex_string_with_alpha());
+
+    core::color reparsed;
+    reparsed.from_hex_string(color.to_hex_string_with_alpha());
+    if (reparsed.hex() != color.hex())
+        fuzz::fail("to_hex_string_with_alpha does not parse back", text);
+
+    for (const char *format : FORMATS)
+        (void)color.format(format);
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef CLRSYNC_FUZZ_FUZZ_INPUT_HPP
+#define CLRSYNC_FUZZ_FUZZ_INPUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace clrsync::fuzz
+{
+// Consumes a fuzzer input front to back. Reads past the end yield zeros, so every input,
+// however short, decodes to something.
+class input_reader
+{
+  public:
+    input_reader(const uint8_t *data, size_t size) : m_data(data), m_size(size)
+    {
+    }
+
+    uint8_t byte()
+    {
+        return m_pos < m_size ? m_data[m_pos++] : 0;
+    }
+
+    uint32_t u32()
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+            value = (value << 8) | byte();
+        return value;
+    }
+
+    bool empty() const
+    {
+        return m_pos >= m_size;
+    }
+
+    std::string rest()
+    {
+        std::string out(reinterpret_cast<const char *>(m_data + m_pos), m_size - m_pos);
+        m_pos = m_size;
+        return out;
+    }
+
+  private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_pos{0};
+};
+
+// Reports a broken invariant with the inputs that produced it, then aborts so the fuzzer
+// saves the crashing input.
+[[noreturn]] inline void fail(const char *what, const std::string &detail)
+{
+    std::fprintf(stderr, "invariant failed: %s\n%s\n", what, detail.c_str());
+    std::abort();
+}
+} // namespace clrsync::fuzz
+
+#endif
@@ -0,0 +1,124 @@
+// Differential fuzzer: renders random templates with random palettes through the tokenized
+// theme_template and the frozen replace_all reference, and requires the same output or the
+// same error from both.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/palette/color_keys.hpp"
+#include "core/palette/palette.hpp"
+#include "core/theme/theme_template.hpp"
+#include "fuzz_input.hpp"
+#include "reference_renderer.hpp"
+
+using namespace clrsync;
+
+namespace
+{
+// Palette keys are mostly drawn from here so templates built from TOKENS hit them. Keys
+// that prefix other keys (border / border_focused, surface / surface_variant) are included.
+const std::vector<std::string> KEYS = {
+    "background", "border", "border_focused", "accent", "surface", "surface_variant",
+    "on_surface", "foreground", "base08",
+};
+
+// Bytes from 0xC0 up stand for whole tokens, so mutations reach well-formed and almost
+// well-formed placeholders far more often than with raw bytes alone.
+const std::vector<std::string> TOKENS = {
+    "{", "}", ".", "{{", "}}", "{.", ".}",
+    "background", "border", "border_focused", "accent", "surface", "surface_variant",
+    "on_surface", "foreground", "base08", "unknown",
+    "hex", "hex_stripped", "hexa", "hexa_stripped", "r", "g", "b", "a", "rgb", "rgba",
+    "h", "s", "l", "hsla_a", "hsl", "hsla",
+    "{background}", "{border.hex}", "{border_focused.rgba}", "{accent.hsl}", "{foo.bar}",
+    "{accent.zz}", "\n",
+};
+
+struct render_result
+{
+    std::string output;
+    std::string error;
+    bool failed{false};
+};
+
+template <typename Fn> render_result capture(Fn &&render)
+{
+    render_result result;
+    try
+    {
+        result.output = render();
+    }
+    catch (const std::exception &e)
+    {
+        result.failed = true;
+        result.error = e.what();
+    }
+    return result;
+}
+
+std::string describe(const std::string &text, const render_result &expected,
+                     const render_result &actual)
+{
+    auto show = [](const render_result &r) {
+        return r.failed ? "error: " + r.error : "output: [" + r.output + "]";
+    };
+    return "template: [" + text + "]\nreference " + show(expected) + "\ntheme_template " +
+           show(actual);
+}
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz::input_reader input(data, size);
+
+    core::palette palette("fuzz");
+    const size_t key_count = input.byte() % 8;
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        const uint8_t pick = input.byte();
+        const std::string key = pick < 0x80 ? KEYS[pick % KEYS.size()]
+                                            : core::COLOR_KEYS[pick % core::NUM_COLOR_KEYS];
+        palette.set_color(key, core::color(input.u32()));
+    }
+
+    std::string text;
+    for (char c : input.rest())
+    {
+        const auto b = static_cast<uint8_t>(c);
+        if (b >= 0xC0)
+            text += TOKENS[(b - 0xC0) % TOKENS.size()];
+        else
+            text += c;
+    }
+
+    if (fuzz::reference_order_dependent(text, palette))
+        return 0;
+
+    std::vector<std::string> keys;
+    for (const auto &[key, color] : palette.colors())
+        keys.push_back(key);
+    std::sort(keys.begin(), keys.end());
+
+    auto expected = capture([&] { return fuzz::reference_render(text, palette, keys); });
+
+    std::reverse(keys.begin(), keys.end());
+    auto reversed = capture([&] { return fuzz::reference_render(text, palette, keys); });
+    if (reversed.failed != expected.failed || reversed.output != expected.output)
+        fuzz::fail("reference depends on key order", describe(text, expected, reversed));
+
+    core::theme_template tmpl;
+    tmpl.set_template_data(text);
+    auto actual = capture([&] {
+        tmpl.apply_palette(palette);
+        return tmpl.processed_template();
+    });
+
+    if (actual.failed != expected.failed || actual.output != expected.output)
+        fuzz::fail("theme_template differs from reference", describe(text, expected, actual));
+
+    return 0;
+}
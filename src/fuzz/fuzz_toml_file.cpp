@@ -0,0 +1,84 @@
+// Fuzzes toml_file and palette_file with arbitrary file contents: parsing and every getter
+// must either succeed or report an error, never throw or crash, and a parsed file must
+// read back the same after save_file().
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+#include "core/io/toml_file.hpp"
+#include "core/palette/palette_file.hpp"
+#include "fuzz_input.hpp"
+
+using namespace clrsync;
+
+namespace
+{
+using table_map = std::map<std::string, value_type>;
+
+const std::filesystem::path &scratch_path()
+{
+    static const std::filesystem::path path =
+        std::filesystem::temp_directory_path() /
+        ("clrsync-fuzz-" + std::to_string(::getpid()) + ".toml");
+    return path;
+}
+
+void write_scratch(const uint8_t *data, size_t size)
+{
+    std::ofstream out(scratch_path(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+
+// The root table and every table one and two levels below it, keyed by section path.
+std::map<std::string, table_map> read_tables(const core::io::toml_file &file)
+{
+    std::map<std::string, table_map> tables;
+    tables[""] = file.get_table("");
+    for (const auto &[key, value] : tables[""])
+    {
+        auto section = file.get_table(key);
+        for (const auto &[sub_key, sub_value] : section)
+            tables[key + "." + sub_key] = file.get_table(key + "." + sub_key);
+        tables[key] = std::move(section);
+
+        (void)file.get_string_value(key, "name");
+        (void)file.get_uint_value(key, "font_size");
+        (void)file.get_bool_value(key, "enabled");
+    }
+    (void)file.get_table("templates");
+    (void)file.get_table("templates.missing");
+    return tables;
+}
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    write_scratch(data, size);
+
+    core::palette_file<core::io::toml_file> palette(scratch_path().string());
+    if (palette.parse())
+        (void)palette.palette();
+
+    core::io::toml_file file(scratch_path().string());
+    if (!file.parse())
+        return 0;
+
+    auto before = read_tables(file);
+
+    if (!file.save_file())
+        fuzz::fail("save_file failed", scratch_path().string());
+
+    core::io::toml_file reloaded(scratch_path().string());
+    if (!reloaded.parse())
+        fuzz::fail("saved file does not parse", scratch_path().string());
+
+    if (read_tables(reloaded) != before)
+        fuzz::fail("saved file reads back differently", scratch_path().string());
+
+    return 0;
+}
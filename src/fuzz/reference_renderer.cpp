@@ -0,0 +1,72 @@
+#include "reference_renderer.hpp"
+
+namespace clrsync::fuzz
+{
+namespace
+{
+void replace_all(std::string &str, const std::string &from, const std::string &to)
+{
+    size_t pos = 0;
+    while ((pos = str.find(from, pos)) != std::string::npos)
+    {
+        str.replace(pos, from.length(), to);
+        pos += to.length();
+    }
+}
+} // namespace
+
+std::string reference_render(const std::string &text, const core::palette &palette,
+                             const std::vector<std::string> &key_order)
+{
+    std::string processed = text;
+
+    for (const auto &key : key_order)
+    {
+        auto it = palette.colors().find(key);
+        if (it == palette.colors().end())
+            continue;
+        const auto &color = it->second;
+
+        // simple replacement: {foreground}
+        replace_all(processed, "{" + key + "}", color.format("hex"));
+
+        // mutli-component: {foreground.r}, {foreground.rgb}, etc.
+        std::string prefix = "{" + key + ".";
+        size_t pos = 0;
+        while ((pos = processed.find(prefix, pos)) != std::string::npos)
+        {
+            size_t end = processed.find('}', pos);
+            if (end == std::string::npos)
+                break;
+
+            const size_t field_start = pos + prefix.size();
+            std::string field = processed.substr(field_start, end - field_start);
+
+            std::string value = color.format(field);
+
+            processed.replace(pos, end - pos + 1, value);
+
+            pos += value.size();
+        }
+    }
+
+    return processed;
+}
+
+bool reference_order_dependent(const std::string &text, const core::palette &palette)
+{
+    for (const auto &[key, color] : palette.colors())
+    {
+        const std::string prefix = "{" + key + ".";
+        for (size_t pos = text.find(prefix); pos != std::string::npos;
+             pos = text.find(prefix, pos + 1))
+        {
+            size_t close = text.find('}', pos);
+            size_t nested = text.find('{', pos + prefix.size());
+            if (close != std::string::npos && nested < close)
+                return true;
+        }
+    }
+    return false;
+}
+} // namespace clrsync::fuzz
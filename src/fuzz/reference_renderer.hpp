@@ -0,0 +1,24 @@
+#ifndef CLRSYNC_FUZZ_REFERENCE_RENDERER_HPP
+#define CLRSYNC_FUZZ_REFERENCE_RENDERER_HPP
+
+#include <string>
+#include <vector>
+
+#include "core/palette/palette.hpp"
+
+namespace clrsync::fuzz
+{
+// The original replace_all renderer, frozen so the tokenized theme_template can be checked
+// against it. Do not "fix" this: it is the specification. It rewrites the text once per
+// key, so keys are visited in the given order rather than the palette's hash order.
+std::string reference_render(const std::string &text, const core::palette &palette,
+                             const std::vector<std::string> &key_order);
+
+// True if the result of reference_render() can depend on key_order: some "{key." with a
+// key from the palette has a '{' before its closing '}', and rewriting one key can then
+// splice a placeholder for another. The tokenizer resolves these one way, the reference
+// another, so the differential fuzzer skips them.
+bool reference_order_dependent(const std::string &text, const core::palette &palette);
+} // namespace clrsync::fuzz
+
+#endif
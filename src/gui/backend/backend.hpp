@@ -23,6 +23,13 @@ namespace clrsync::gui::backend{
         virtual void begin_frame() = 0;
         virtual void end_frame() = 0;
 
+        // Event pumping is separate from begin_frame() so the loop can sleep while idle.
+        virtual void poll_events() = 0;
+        // Blocks until an event arrives or `timeout` seconds pass; negative waits forever.
+        virtual void wait_events(double timeout) = 0;
+        // Wakes a pending wait_events(); safe to call from any thread.
+        virtual void post_empty_event() = 0;
+
         virtual void* get_native_window() const = 0;
         virtual void* get_graphics_context() const = 0;
         
@@ -69,8 +69,6 @@ bool glfw_opengl_backend::should_close() const
 
 void glfw_opengl_backend::begin_frame()
 {
-    glfwPollEvents();
-    
     if (m_window)
     {
         int display_w, display_h;
@@ -89,6 +87,24 @@ void glfw_opengl_backend::end_frame()
     }
 }
 
+void glfw_opengl_backend::poll_events()
+{
+    glfwPollEvents();
+}
+
+void glfw_opengl_backend::wait_events(double timeout)
+{
+    if (timeout < 0.0)
+        glfwWaitEvents();
+    else
+        glfwWaitEventsTimeout(timeout);
+}
+
+void glfw_opengl_backend::post_empty_event()
+{
+    glfwPostEmptyEvent();
+}
+
 void *glfw_opengl_backend::get_native_window() const
 {
     return static_cast<void *>(m_window);
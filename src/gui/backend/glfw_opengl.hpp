@@ -19,6 +19,9 @@ namespace clrsync::gui::backend{
         bool should_close() const override;
         void begin_frame() override;
         void end_frame() override;
+        void poll_events() override;
+        void wait_events(double timeout) override;
+        void post_empty_event() override;
 
         void* get_native_window() const override;
         void* get_graphics_context() const override;
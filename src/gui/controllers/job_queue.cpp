@@ -0,0 +1,140 @@
+#include "gui/controllers/job_queue.hpp"
+#include <algorithm>
+#include <exception>
+
+job_queue::job_queue(size_t workers)
+{
+    for (size_t i = 0; i < std::max<size_t>(workers, 1); ++i)
+        m_workers.emplace_back([this] { worker_loop(); });
+}
+
+job_queue::~job_queue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+void job_queue::submit(std::string label, std::string strand, work fn)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(job{std::move(label), std::move(strand), std::move(fn)});
+    }
+    m_wake.notify_one();
+}
+
+void job_queue::set_notifier(std::function<void()> notifier)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_notifier = std::move(notifier);
+}
+
+void job_queue::poll()
+{
+    std::vector<job_result> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        finished.swap(m_finished);
+    }
+    for (auto &result : finished)
+    {
+        if (result.then)
+            result.then();
+        if (result.message.empty())
+            continue;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_status = std::move(result.message);
+    }
+}
+
+bool job_queue::busy() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_queue.empty() || !m_running.empty();
+}
+
+std::string job_queue::status() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::string *first = nullptr;
+    size_t pending = 0;
+    auto count = [&](const std::string &label) {
+        if (label.empty())
+            return;
+        if (!first)
+            first = &label;
+        ++pending;
+    };
+    for (const auto &label : m_running)
+        count(label);
+    for (const auto &queued : m_queue)
+        count(queued.label);
+    if (pending == 0)
+        return m_status;
+
+    std::string text = *first + "...";
+    if (pending > 1)
+        text += " (+" + std::to_string(pending - 1) + " more)";
+    return text;
+}
+
+// Called with m_mutex held. Takes the oldest job whose strand is free.
+bool job_queue::take_job(job &out)
+{
+    for (auto it = m_queue.begin(); it != m_queue.end(); ++it)
+    {
+        if (!it->strand.empty() && m_busy_strands.count(it->strand))
+            continue;
+        out = std::move(*it);
+        m_queue.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void job_queue::worker_loop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        job current;
+        m_wake.wait(lock, [&] { return m_stop || take_job(current); });
+        if (m_stop)
+            return;
+
+        if (!current.strand.empty())
+            m_busy_strands.insert(current.strand);
+        m_running.push_back(current.label);
+        lock.unlock();
+
+        job_result result;
+        try
+        {
+            result = current.fn();
+        }
+        catch (const std::exception &e)
+        {
+            result = {current.label + " failed: " + e.what(), {}};
+        }
+
+        lock.lock();
+        m_running.erase(std::find(m_running.begin(), m_running.end(), current.label));
+        if (!current.strand.empty())
+            m_busy_strands.erase(current.strand);
+        m_finished.push_back(std::move(result));
+        auto notify = m_notifier;
+        lock.unlock();
+
+        // A freed strand may unblock a queued job for another worker.
+        m_wake.notify_all();
+        if (notify)
+            notify();
+        lock.lock();
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef CLRSYNC_GUI_JOB_QUEUE_HPP
+#define CLRSYNC_GUI_JOB_QUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Runs slow work (disk I/O, reload commands) on worker threads so the frame loop never waits
+// for it. Each job's result comes back to the thread that calls poll(), where it may touch
+// GUI state. Jobs on the same strand run one at a time, in the order they were submitted.
+class job_queue
+{
+  public:
+    struct job_result
+    {
+        // Shown as the status once the job has finished.
+        std::string message;
+        // Runs in poll(); may be empty.
+        std::function<void()> then;
+    };
+    using work = std::function<job_result()>;
+
+    explicit job_queue(size_t workers = 2);
+    // Waits for running jobs; queued ones are dropped.
+    ~job_queue();
+
+    job_queue(const job_queue &) = delete;
+    job_queue &operator=(const job_queue &) = delete;
+
+    // `work` runs on a worker and must not touch GUI or config state; capture what it needs.
+    // A job with an empty label runs in the background: it never shows in status(), and an
+    // empty message leaves the status as it was.
+    void submit(std::string label, std::string strand, work fn);
+
+    // Called on a worker thread whenever a job finishes, e.g. to wake an idle frame loop.
+    void set_notifier(std::function<void()> notifier);
+
+    // Applies the results of finished jobs. Call once per frame from the GUI thread.
+    void poll();
+
+    bool busy() const;
+    // What the queue is doing ("Applying dark..."), or the last finished job's message.
+    std::string status() const;
+
+  private:
+    struct job
+    {
+        std::string label;
+        std::string strand;
+        work fn;
+    };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<job> m_queue;
+    std::vector<std::string> m_running;
+    std::unordered_set<std::string> m_busy_strands;
+    std::vector<job_result> m_finished;
+    std::function<void()> m_notifier;
+    std::string m_status;
+    bool m_stop{false};
+    std::vector<std::thread> m_workers;
+
+    void worker_loop();
+    bool take_job(job &out);
+};
+
+#endif // CLRSYNC_GUI_JOB_QUEUE_HPP
@@ -0,0 +1,67 @@
+#include "gui/controllers/palette_change_bus.hpp"
+#include "gui/widgets/colors.hpp"
+
+palette_change_bus::key_set palette_change_bus::all_keys()
+{
+    return key_set{}.set();
+}
+
+palette_change_bus::key_set palette_change_bus::keys(std::initializer_list<clrsync::core::color_key> names)
+{
+    key_set set;
+    for (clrsync::core::color_key key : names)
+        set.set(key.index());
+    return set;
+}
+
+void palette_change_bus::subscribe(const key_set &keys, listener callback, bool throttled)
+{
+    m_subscribers.push_back(subscriber{keys, std::move(callback), throttled});
+}
+
+void palette_change_bus::set_throttle_interval(clock::duration interval)
+{
+    m_interval = interval;
+}
+
+void palette_change_bus::mark_changed(std::string_view key)
+{
+    const size_t i = clrsync::gui::widgets::resolved_palette::index_of(key);
+    if (i < m_changed.size())
+        m_changed.set(i);
+}
+
+void palette_change_bus::mark_all_changed()
+{
+    m_changed.set();
+    m_replaced = true;
+}
+
+void palette_change_bus::flush(const clrsync::core::palette &pal)
+{
+    const auto now = clock::now();
+    for (auto &sub : m_subscribers)
+    {
+        sub.pending |= m_changed & sub.keys;
+        if (sub.pending.none())
+            continue;
+        if (sub.throttled && !m_replaced && now - sub.last_update < m_interval)
+            continue;
+
+        sub.callback(pal, sub.pending);
+        sub.pending.reset();
+        sub.last_update = now;
+    }
+    m_changed.reset();
+    m_replaced = false;
+}
+
+bool palette_change_bus::has_pending() const
+{
+    for (const auto &sub : m_subscribers)
+    {
+        if (sub.pending.any())
+            return true;
+    }
+    return false;
+}
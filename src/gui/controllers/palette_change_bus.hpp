@@ -0,0 +1,59 @@
+#ifndef CLRSYNC_GUI_PALETTE_CHANGE_BUS_HPP
+#define CLRSYNC_GUI_PALETTE_CHANGE_BUS_HPP
+
+#include "core/palette/color_keys.hpp"
+#include "core/palette/palette.hpp"
+#include <bitset>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+// Collects palette edits and hands them to subscribers once per flush, so a color picker
+// dragged across many frames costs each consumer one update per frame at most. Subscribers
+// name the keys they read; throttled ones hear at most once per interval, with every key
+// that changed in between.
+class palette_change_bus
+{
+  public:
+    using key_set = std::bitset<clrsync::core::NUM_COLOR_KEYS>;
+    using listener = std::function<void(const clrsync::core::palette &, const key_set &)>;
+    using clock = std::chrono::steady_clock;
+
+    static key_set all_keys();
+    // Names that are not in core::COLOR_KEYS do not compile.
+    static key_set keys(std::initializer_list<clrsync::core::color_key> names);
+
+    void subscribe(const key_set &keys, listener callback, bool throttled = false);
+    // Shortest time between two updates of a throttled subscriber; zero disables throttling.
+    void set_throttle_interval(clock::duration interval);
+
+    void mark_changed(std::string_view key);
+    // The whole palette was replaced. The next flush reaches every subscriber, throttled or
+    // not, since switching palettes is a single step rather than a stream of edits.
+    void mark_all_changed();
+
+    // Delivers what was marked since the last flush. Throttled subscribers still inside
+    // their interval keep their keys for a later flush.
+    void flush(const clrsync::core::palette &pal);
+    // True while a throttled subscriber holds undelivered changes.
+    bool has_pending() const;
+
+  private:
+    struct subscriber
+    {
+        key_set keys;
+        listener callback;
+        bool throttled;
+        key_set pending{};
+        clock::time_point last_update{};
+    };
+
+    std::vector<subscriber> m_subscribers;
+    key_set m_changed{};
+    bool m_replaced{false};
+    clock::duration m_interval{};
+};
+
+#endif // CLRSYNC_GUI_PALETTE_CHANGE_BUS_HPP
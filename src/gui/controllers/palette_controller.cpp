@@ -2,25 +2,19 @@
 #include "core/config/config.hpp"
 #include "core/theme/theme_renderer.hpp"
 
+namespace
+{
+// Serializes everything that uses the palette manager. Applies run here too, so they see
+// every save submitted before them and never overlap each other's outputs and bundles.
+constexpr const char *PALETTES_STRAND = "palettes";
+} // namespace
+
 palette_controller::palette_controller()
 {
-    m_palette_manager.load_palettes_from_directory(
+    m_palette_manager->load_palettes_from_directory(
         clrsync::core::config::instance().palettes_path());
-    m_palettes = m_palette_manager.palettes();
-
-    if (m_palettes.empty())
-        return;
-
-    auto default_theme = clrsync::core::config::instance().default_theme();
-    auto it = m_palettes.find(default_theme);
-    if (it != m_palettes.end())
-    {
-        m_current_palette = it->second;
-    }
-    else
-    {
-        m_current_palette = m_palettes.begin()->second;
-    }
+    m_palettes = m_palette_manager->palettes();
+    pick_current_palette();
 }
 
 void palette_controller::select_palette(const std::string &name)
@@ -28,53 +22,149 @@ void palette_controller::select_palette(const std::string &name)
     auto it = m_palettes.find(name);
     if (it != m_palettes.end())
     {
-        m_current_palette = it->second;
+        set_current_palette(it->second);
     }
 }
 
-void palette_controller::create_palette(const std::string &name)
+void palette_controller::create_palette(const std::string &name, on_done done)
 {
-    clrsync::core::palette new_palette(name);
-
-    for (const auto &[key, hex_value] : clrsync::core::DEFAULT_COLORS)
-    {
-        new_palette.set_color(key, clrsync::core::color(hex_value));
-    }
-
     auto dir = clrsync::core::config::instance().palettes_path();
-    m_palette_manager.save_palette_to_file(new_palette, dir);
-
-    reload_palettes();
-    m_current_palette = new_palette;
+    update_library(
+        "Creating " + name, dir,
+        [name, dir](manager_type &manager) {
+            clrsync::core::palette new_palette(name);
+            for (const auto &[key, hex_value] : clrsync::core::DEFAULT_COLORS)
+            {
+                new_palette.set_color(key, clrsync::core::color(hex_value));
+            }
+            manager.save_palette_to_file(new_palette, dir);
+            return "Created " + name;
+        },
+        [this, name, done] {
+            select_palette(name);
+            if (done)
+                done();
+        });
 }
 
 void palette_controller::save_current_palette()
 {
+    auto pal = m_current_palette;
     auto dir = clrsync::core::config::instance().palettes_path();
-    m_palette_manager.save_palette_to_file(m_current_palette, dir);
-    reload_palettes();
+    update_library(
+        "Saving " + pal->name(), dir,
+        [pal, dir](manager_type &manager) {
+            manager.save_palette_to_file(*pal, dir);
+            return "Saved " + pal->name();
+        },
+        {});
 }
 
-void palette_controller::delete_current_palette()
+void palette_controller::delete_current_palette(on_done done)
 {
-    m_palette_manager.delete_palette(m_current_palette.file_path(), m_current_palette.name());
-    reload_palettes();
+    auto pal = m_current_palette;
+    update_library(
+        "Deleting " + pal->name(), clrsync::core::config::instance().palettes_path(),
+        [pal](manager_type &manager) {
+            manager.delete_palette(pal->file_path(), pal->name());
+            return "Deleted " + pal->name();
+        },
+        [this, done] {
+            pick_current_palette();
+            if (done)
+                done();
+        });
 }
 
-void palette_controller::apply_current_theme() const
+void palette_controller::apply_current_theme(const clrsync::core::template_filter &filter)
 {
-    clrsync::core::theme_renderer<clrsync::core::io::toml_file> theme_renderer;
-    (void)theme_renderer.apply_theme(m_current_palette.name());
+    const std::string name = m_current_palette->name();
+    // Copies: the config is only safe to read from this thread.
+    auto &cfg = clrsync::core::config::instance();
+    auto templates = cfg.templates();
+    const auto snap = cfg.snapshot();
+
+    run("Applying " + name, PALETTES_STRAND,
+        [manager = m_palette_manager, name, filter, templates = std::move(templates),
+         cache_mb = snap->render_cache_mb, bundles = snap->bundles]() mutable {
+            // Looked up here rather than in m_palettes, which a pending save has not
+            // updated yet.
+            auto saved = manager->find_palette(name);
+            if (!saved)
+                return job_queue::job_result{"Palette not found: " + name, {}};
+            clrsync::core::theme_renderer<clrsync::core::io::toml_file> renderer(
+                std::move(templates), cache_mb, bundles);
+            auto result = renderer.apply_palette_to_all_templates(*saved, filter);
+            if (!result)
+                return job_queue::job_result{
+                    "Applying " + name + " failed: " + result.error().description(), {}};
+            return job_queue::job_result{"Applied " + name, {}};
+        });
 }
 
 void palette_controller::set_color(const std::string &key, const clrsync::core::color &color)
 {
-    m_current_palette.set_color(key, color);
+    // Copy on write: views and the library may still hold the current palette.
+    auto edited = std::make_shared<clrsync::core::palette>(*m_current_palette);
+    edited->set_color(key, color);
+    set_current_palette(std::move(edited));
 }
 
-void palette_controller::reload_palettes()
+void palette_controller::reload_from_config(on_done done)
 {
-    m_palette_manager.load_palettes_from_directory(
-        clrsync::core::config::instance().palettes_path());
-    m_palettes = m_palette_manager.palettes();
+    update_library(
+        "Loading palettes", clrsync::core::config::instance().palettes_path(),
+        [](manager_type &) { return std::string("Palettes reloaded"); },
+        [this, done] {
+            pick_current_palette();
+            if (done)
+                done();
+        });
+}
+
+void palette_controller::run(std::string label, std::string strand, job_queue::work fn)
+{
+    if (m_jobs)
+    {
+        m_jobs->submit(std::move(label), std::move(strand), std::move(fn));
+        return;
+    }
+    auto result = fn();
+    if (result.then)
+        result.then();
+}
+
+void palette_controller::update_library(std::string label, std::string dir,
+                                        std::function<std::string(manager_type &)> change,
+                                        std::function<void()> then)
+{
+    run(std::move(label), PALETTES_STRAND,
+        [this, manager = m_palette_manager, dir = std::move(dir), change = std::move(change),
+         then = std::move(then)] {
+            std::string message = change(*manager);
+            manager->load_palettes_from_directory(dir);
+            return job_queue::job_result{
+                std::move(message), [this, palettes = manager->palettes(), then] {
+                    m_palettes = palettes;
+                    if (then)
+                        then();
+                }};
+        });
+}
+
+void palette_controller::pick_current_palette()
+{
+    auto it = m_palettes.find(m_current_palette->name());
+    if (it == m_palettes.end())
+        it = m_palettes.find(clrsync::core::config::instance().default_theme());
+    if (it == m_palettes.end())
+        it = m_palettes.begin();
+    if (it != m_palettes.end())
+        set_current_palette(it->second);
+}
+
+void palette_controller::set_current_palette(clrsync::core::palette_ptr palette)
+{
+    m_current_palette = std::move(palette);
+    m_resolved_palette = clrsync::gui::widgets::resolved_palette(*m_current_palette);
 }
@@ -3,36 +3,78 @@
 
 #include "core/io/toml_file.hpp"
 #include "core/palette/palette_manager.hpp"
+#include "core/theme/template_filter.hpp"
+#include "gui/controllers/job_queue.hpp"
+#include "gui/widgets/colors.hpp"
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 class palette_controller
 {
   public:
+    using on_done = std::function<void()>;
+
     palette_controller();
 
+    // From now on disk work and applies run as jobs; without a queue they run inline.
+    void set_job_queue(job_queue *jobs)
+    {
+        m_jobs = jobs;
+    }
+
     const clrsync::core::palette &current_palette() const
+    {
+        return *m_current_palette;
+    }
+    // Never null. Holders keep the palette as it was; edits publish a new one.
+    const clrsync::core::palette_ptr &current_palette_ptr() const
     {
         return m_current_palette;
     }
-    const std::unordered_map<std::string, clrsync::core::palette> &palettes() const
+    // The current palette's colors ready for drawing; rebuilt whenever the palette changes.
+    const clrsync::gui::widgets::resolved_palette &resolved_palette() const
+    {
+        return m_resolved_palette;
+    }
+    // The library as of the last finished scan.
+    const std::unordered_map<std::string, clrsync::core::palette_ptr> &palettes() const
     {
         return m_palettes;
     }
 
     void select_palette(const std::string &name);
-    void create_palette(const std::string &name);
+    // The methods below return at once; `done` runs on the GUI thread once the library
+    // reflects the change.
+    void create_palette(const std::string &name, on_done done = {});
     void save_current_palette();
-    void delete_current_palette();
-    void apply_current_theme() const;
+    void delete_current_palette(on_done done = {});
+    // Renders the saved version of the current palette, like the CLI would.
+    void apply_current_theme(const clrsync::core::template_filter &filter = {});
     void set_color(const std::string &key, const clrsync::core::color &color);
+    // Re-reads the palettes directory after the config changed, keeping the current selection
+    // when it still exists.
+    void reload_from_config(on_done done = {});
 
   private:
-    void reload_palettes();
+    using manager_type = clrsync::core::palette_manager<clrsync::core::io::toml_file>;
+    using palette_map = std::unordered_map<std::string, clrsync::core::palette_ptr>;
+
+    void run(std::string label, std::string strand, job_queue::work fn);
+    // Runs `change` against the manager, rescans `dir` and publishes the result.
+    void update_library(std::string label, std::string dir,
+                        std::function<std::string(manager_type &)> change,
+                        std::function<void()> then);
+    void pick_current_palette();
+    void set_current_palette(clrsync::core::palette_ptr palette);
 
-    clrsync::core::palette_manager<clrsync::core::io::toml_file> m_palette_manager;
-    std::unordered_map<std::string, clrsync::core::palette> m_palettes;
-    clrsync::core::palette m_current_palette;
+    // Only touched by jobs on the palettes strand once the constructor has returned.
+    std::shared_ptr<manager_type> m_palette_manager{std::make_shared<manager_type>()};
+    palette_map m_palettes;
+    job_queue *m_jobs{nullptr};
+    clrsync::core::palette_ptr m_current_palette{std::make_shared<clrsync::core::palette>()};
+    clrsync::gui::widgets::resolved_palette m_resolved_palette;
 };
 
 #endif // CLRSYNC_GUI_PALETTE_CONTROLLER_HPP
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "gui/controllers/template_preview.hpp"
+#include "core/theme/theme_template.hpp"
+#include <exception>
+
+namespace
+{
+constexpr const char *PREVIEW_STRAND = "template_preview";
+
+using substitution = clrsync::core::theme_template::substitution;
+
+// RRGGBBAA to ImGui's AABBGGRR, with black or white text, whichever reads better on it.
+template_preview::highlight make_highlight(const substitution &sub)
+{
+    const uint32_t r = (sub.color >> 24) & 0xFF;
+    const uint32_t g = (sub.color >> 16) & 0xFF;
+    const uint32_t b = (sub.color >> 8) & 0xFF;
+    const uint32_t a = sub.color & 0xFF;
+    const bool light = r * 299 + g * 587 + b * 114 > 140 * 1000;
+    return {sub.offset, sub.offset + sub.length, (a << 24) | (b << 16) | (g << 8) | r,
+            light ? 0xFF000000u : 0xFFFFFFFFu};
+}
+
+template_preview::line_ptr render_line(const std::string &text,
+                                       const clrsync::core::palette &palette,
+                                       clrsync::core::theme_template &tmpl,
+                                       std::vector<substitution> &subs)
+{
+    auto result = std::make_shared<template_preview::line>();
+    tmpl.set_template_data(text);
+    try
+    {
+        tmpl.render(palette, result->text, subs);
+    }
+    catch (const std::exception &)
+    {
+        result->text = text;
+        result->failed = true;
+        return result;
+    }
+    result->highlights.reserve(subs.size());
+    for (const auto &sub : subs)
+        result->highlights.push_back(make_highlight(sub));
+    return result;
+}
+} // namespace
+
+void template_preview::set_palette(clrsync::core::palette_ptr palette)
+{
+    if (palette == m_palette)
+        return;
+    m_palette = std::move(palette);
+    mark_stale();
+}
+
+void template_preview::update(const TextEditor &editor)
+{
+    const uint64_t generation = editor.GetEditGeneration();
+    if (generation != m_seen_generation)
+    {
+        m_seen_generation = generation;
+        mark_stale();
+    }
+
+    if (!m_stale || m_in_flight || !m_palette ||
+        std::chrono::steady_clock::now() - m_changed_at < DEBOUNCE)
+        return;
+    m_stale = false;
+    m_in_flight = true;
+
+    job_queue::work fn = [this, alive = std::weak_ptr<const bool>(m_alive),
+                          text = editor.GetTextLines(), palette = m_palette, cached = m_cache] {
+        return job_queue::job_result{
+            {}, [this, alive, lines = render(text, palette, *cached)]() mutable {
+                // Checked on the GUI thread, which is also where the preview is destroyed.
+                if (alive.expired())
+                    return;
+                m_lines = std::move(lines);
+                m_in_flight = false;
+            }};
+    };
+    if (m_jobs)
+    {
+        m_jobs->submit({}, PREVIEW_STRAND, std::move(fn));
+        return;
+    }
+    fn().then();
+}
+
+void template_preview::mark_stale()
+{
+    m_stale = true;
+    m_changed_at = std::chrono::steady_clock::now();
+}
+
+// Lines render on their own, so an unchanged line is reused as it is. Only a malformed
+// placeholder can span lines, and the preview shows it as written.
+std::vector<template_preview::line_ptr> template_preview::render(
+    const std::vector<std::string> &text, const clrsync::core::palette_ptr &palette,
+    cache &cached)
+{
+    if (cached.palette != palette)
+    {
+        cached.lines.clear();
+        cached.palette = palette;
+    }
+
+    std::unordered_map<std::string, line_ptr> kept;
+    kept.reserve(text.size());
+    std::vector<line_ptr> lines;
+    lines.reserve(text.size());
+
+    clrsync::core::theme_template tmpl;
+    std::vector<substitution> subs;
+    for (const auto &source : text)
+    {
+        auto [it, inserted] = kept.try_emplace(source);
+        if (inserted)
+        {
+            auto old = cached.lines.find(source);
+            it->second = old != cached.lines.end() ? old->second
+                                                   : render_line(source, *palette, tmpl, subs);
+        }
+        lines.push_back(it->second);
+    }
+    cached.lines = std::move(kept);
+    return lines;
+}
@@ -0,0 +1,96 @@
+#ifndef CLRSYNC_GUI_TEMPLATE_PREVIEW_HPP
+#define CLRSYNC_GUI_TEMPLATE_PREVIEW_HPP
+
+#include "color_text_edit/TextEditor.h"
+#include "core/palette/palette.hpp"
+#include "gui/controllers/job_queue.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The template being edited, rendered against a palette for the editor's preview pane.
+// Rendering runs as a background job once the text has been still for a moment, and lines
+// whose text did not change since the last render are reused, so a keystroke in a long
+// template renders one line.
+class template_preview
+{
+  public:
+    // A substituted value, packed for ImGui draw lists.
+    struct highlight
+    {
+        size_t begin{0};
+        size_t end{0};
+        uint32_t fill{0};
+        uint32_t text{0};
+    };
+
+    struct line
+    {
+        std::string text;
+        std::vector<highlight> highlights;
+        // Rendering threw (an unknown format); `text` is the line as written.
+        bool failed{false};
+    };
+    using line_ptr = std::shared_ptr<const line>;
+
+    template_preview() = default;
+    // Render jobs hold on to this preview's address.
+    template_preview(const template_preview &) = delete;
+    template_preview &operator=(const template_preview &) = delete;
+
+    // Without a queue, rendering runs inline.
+    void set_job_queue(job_queue *jobs)
+    {
+        m_jobs = jobs;
+    }
+
+    // Palettes are compared by identity: pass the shared palette rather than a copy, or every
+    // call throws away the rendered lines.
+    void set_palette(clrsync::core::palette_ptr palette);
+
+    // Call every frame the preview is shown. Starts a render once the editor's text has
+    // settled and the previous render has finished.
+    void update(const TextEditor &editor);
+
+    // True while a change is waiting out the debounce; keep frames coming until it is not.
+    bool waiting() const
+    {
+        return m_stale && !m_in_flight;
+    }
+
+    const std::vector<line_ptr> &lines() const
+    {
+        return m_lines;
+    }
+
+  private:
+    struct cache
+    {
+        clrsync::core::palette_ptr palette;
+        std::unordered_map<std::string, line_ptr> lines;
+    };
+
+    static constexpr std::chrono::milliseconds DEBOUNCE{150};
+
+    job_queue *m_jobs{nullptr};
+    clrsync::core::palette_ptr m_palette;
+    std::vector<line_ptr> m_lines;
+    // Only touched by render jobs, which run one at a time on the preview strand.
+    std::shared_ptr<cache> m_cache{std::make_shared<cache>()};
+
+    uint64_t m_seen_generation{0};
+    std::chrono::steady_clock::time_point m_changed_at{};
+    bool m_stale{true};
+    bool m_in_flight{false};
+    // Expires with this preview, so a render that finishes afterwards drops its result.
+    std::shared_ptr<const bool> m_alive{std::make_shared<const bool>(true)};
+
+    void mark_stale();
+    static std::vector<line_ptr> render(const std::vector<std::string> &text,
+                                        const clrsync::core::palette_ptr &palette, cache &cached);
+};
+
+#endif // CLRSYNC_GUI_TEMPLATE_PREVIEW_HPP
@@ -44,6 +44,13 @@ void main_layout::render_menu_bar()
     float window_height = ImGui::GetWindowHeight();
     float center_y = (window_height - button_height) * 0.5f;
 
+    if (!m_status.empty())
+    {
+        ImGui::SetCursorPos(ImVec2(style.WindowPadding.x, center_y));
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextDisabled("%s", m_status.c_str());
+    }
+
     ImGui::SetCursorPos(ImVec2(pos_x, center_y));
 
     if (ImGui::Button(settings_label))
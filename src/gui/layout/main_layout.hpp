@@ -1,6 +1,8 @@
 #ifndef CLRSYNC_GUI_LAYOUT_MAIN_LAYOUT_HPP
 #define CLRSYNC_GUI_LAYOUT_MAIN_LAYOUT_HPP
 
+#include <string>
+
 namespace clrsync::gui::layout
 {
 
@@ -9,6 +11,8 @@ class main_layout
   public:
     void setup_dockspace(bool &first_time);
     void render_menu_bar();
+    // Shown at the left of the menu bar, e.g. what background jobs are doing.
+    void set_status(std::string status) { m_status = std::move(status); }
 
     bool should_show_about() const { return m_show_about; }
     bool should_show_settings() const { return m_show_settings; }
@@ -21,6 +25,7 @@ class main_layout
   private:
     bool m_show_about = false;
     bool m_show_settings = false;
+    std::string m_status;
 };
 
 } // namespace clrsync::gui::layout
@@ -7,6 +7,7 @@
 #include "core/io/toml_file.hpp"
 
 #include "gui/backend/glfw_opengl.hpp"
+#include "gui/controllers/job_queue.hpp"
 #include "gui/layout/main_layout.hpp"
 #include "gui/ui_manager.hpp"
 #include "gui/views/about_window.hpp"
@@ -71,12 +72,44 @@ int main(int, char **)
 
     colorEditor.set_template_editor(&templateEditor);
     colorEditor.set_settings_window(&settingsWindow);
-    templateEditor.apply_current_palette(colorEditor.controller().current_palette());
-    settingsWindow.set_palette(colorEditor.controller().current_palette());
-
+    job_queue jobs;
+    jobs.set_notifier([&] { ui_manager.request_redraw(); });
+    colorEditor.set_job_queue(&jobs);
+    templateEditor.set_job_queue(&jobs);
+
+    templateEditor.apply_current_palette(colorEditor.controller().current_palette_ptr());
+    settingsWindow.set_palette(colorEditor.controller().resolved_palette());
+
+    auto &config = clrsync::core::config::instance();
+    auto watch_result = config.watch(config_path);
+    if (!watch_result)
+        std::cerr << "Config changes on disk will not be picked up: "
+                  << watch_result.error().description() << std::endl;
+
+    config.subscribe([&](const clrsync::core::config_diff &diff,
+                         const clrsync::core::config_snapshot &snapshot) {
+        if (diff.font || diff.font_size)
+            ui_manager.reload_font(snapshot.font.c_str(), static_cast<float>(snapshot.font_size));
+        if (diff.palettes_path)
+            colorEditor.reload_palettes();
+        if (diff.templates)
+            templateEditor.refresh_templates();
+        if (diff.gui_sync)
+            colorEditor.set_sync_rate(snapshot.gui_sync_hz);
+        // A rebuilt font atlas only shows up on the following frames.
+        ui_manager.request_redraw();
+    });
+    config.set_change_notifier([&] { ui_manager.request_redraw(); });
+
+    // Draw the first frames before waiting for input, or the window stays blank until an event.
+    ui_manager.request_redraw();
     while (!backend.should_close())
     {
+        ui_manager.wait_for_frame();
         backend.begin_frame();
+        config.poll();
+        jobs.poll();
+        main_layout.set_status(jobs.status());
         
         ui_manager.push_default_font();
         ui_manager.begin_frame();
@@ -93,15 +126,21 @@ int main(int, char **)
         templateEditor.render();
         colorEditor.render_controls_and_colors();
         colorEditor.render_preview();
-        aboutWindow.render(colorEditor.controller().current_palette());
+        aboutWindow.render(colorEditor.controller().resolved_palette());
         settingsWindow.render();
 
         ui_manager.pop_font();
         
         ui_manager.end_frame();
         backend.end_frame();
+
+        if (colorEditor.has_pending_changes())
+            ui_manager.request_redraw(1);
     }
 
+    config.stop_watching();
+    config.set_change_notifier(nullptr);
+    jobs.set_notifier(nullptr);
     ui_manager.shutdown();
     backend.shutdown();
     return 0;
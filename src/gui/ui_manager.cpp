@@ -50,12 +50,8 @@ bool ui_manager::initialize(const ui_config& config)
         return false;
     }
 
-    ImFont *font = m_font_loader->load_font(
-        clrsync::core::config::instance().font().c_str(),
-        clrsync::core::config::instance().font_size());
-
-    if (font)
-        io.FontDefault = font;
+    auto snapshot = clrsync::core::config::instance().snapshot();
+    reload_font(snapshot->font.c_str(), static_cast<float>(snapshot->font_size));
 
     return true;
 }
@@ -70,6 +66,46 @@ void ui_manager::shutdown()
     }
 }
 
+namespace
+{
+// ImGui settles hover state, popups and layout over a couple of frames after each input.
+constexpr int SETTLE_FRAMES = 2;
+// Half of ImGui's text cursor blink period, so the blink stays visible.
+constexpr double CURSOR_BLINK_INTERVAL = 0.4;
+// Often enough for hover highlights and tooltip delays to resolve without mouse motion.
+constexpr double HOVER_INTERVAL = 0.1;
+} // namespace
+
+void ui_manager::wait_for_frame()
+{
+    int pending = m_redraw_frames.load();
+    while (pending > 0 && !m_redraw_frames.compare_exchange_weak(pending, pending - 1))
+    {
+    }
+    if (pending > 0)
+    {
+        m_backend->poll_events();
+        return;
+    }
+
+    m_backend->wait_events(m_idle_timeout);
+    request_frames(SETTLE_FRAMES);
+}
+
+void ui_manager::request_redraw(int frames)
+{
+    request_frames(frames);
+    m_backend->post_empty_event();
+}
+
+void ui_manager::request_frames(int frames)
+{
+    int pending = m_redraw_frames.load();
+    while (pending < frames && !m_redraw_frames.compare_exchange_weak(pending, frames))
+    {
+    }
+}
+
 void ui_manager::begin_frame()
 {
     m_backend->imgui_new_frame();
@@ -80,6 +116,13 @@ void ui_manager::end_frame()
 {
     ImGui::Render();
     m_backend->imgui_render_draw_data(ImGui::GetDrawData());
+
+    if (ImGui::GetIO().WantTextInput)
+        m_idle_timeout = CURSOR_BLINK_INTERVAL;
+    else if (ImGui::IsAnyItemHovered() || ImGui::IsAnyItemActive())
+        m_idle_timeout = HOVER_INTERVAL;
+    else
+        m_idle_timeout = -1.0;
 }
 
 void ui_manager::push_default_font()
@@ -105,11 +148,17 @@ bool ui_manager::reload_font(const char* font_name, float size)
 {
     if (!m_font_loader)
         return false;
-    
+
+    // Settings apply and the config change notification both ask for the same font.
+    if (m_font_name == font_name && m_font_size == size)
+        return true;
+
     ImFont* font = m_font_loader->load_font(font_name, size);
     if (font)
     {
         ImGui::GetIO().FontDefault = font;
+        m_font_name = font_name;
+        m_font_size = size;
         return true;
     }
     return false;
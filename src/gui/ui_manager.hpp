@@ -1,5 +1,6 @@
 #ifndef CLRSYNC_UI_MANAGER_HPP
 #define CLRSYNC_UI_MANAGER_HPP
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -30,6 +31,14 @@ public:
     bool initialize(const ui_config& config = ui_config());
     void shutdown();
 
+    // Pumps window events, sleeping while nothing needs drawing: it returns on input, on
+    // request_redraw(), or when an animation (text cursor, hover delay) needs a frame.
+    // Call once per loop iteration, before the frame is built.
+    void wait_for_frame();
+    // Renders at least the next `frames` frames even without input, e.g. after background
+    // work changed what a view shows. Safe to call from any thread.
+    void request_redraw(int frames = 2);
+
     void begin_frame();
     void end_frame();
 
@@ -52,6 +61,13 @@ private:
     backend::backend_interface *m_backend;
     void *m_imgui_context = nullptr;
     font_loader *m_font_loader = nullptr;
+    std::string m_font_name;
+    float m_font_size = 0.0f;
+    std::atomic<int> m_redraw_frames{0};
+    // Seconds wait_for_frame() may sleep without input; negative sleeps until an event.
+    double m_idle_timeout = -1.0;
+
+    void request_frames(int frames);
 };
 }
 
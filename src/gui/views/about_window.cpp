@@ -7,7 +7,7 @@
 
 about_window::about_window() = default;
 
-void about_window::render(const clrsync::core::palette &pal)
+void about_window::render(const clrsync::gui::widgets::resolved_palette &pal)
 {
     if (!m_visible)
         return;
@@ -18,10 +18,10 @@ void about_window::render(const clrsync::core::palette &pal)
     {
         using namespace clrsync::gui::widgets;
 
-        ImVec4 title_color = palette_color(pal, "info", "accent");
+        ImVec4 title_color = pal.color("info", "accent");
         centered_text("clrsync", title_color);
 
-        ImVec4 subtitle_color = palette_color(pal, "editor_inactive", "foreground");
+        ImVec4 subtitle_color = pal.color("editor_inactive", "foreground");
         centered_text("Version " + clrsync::core::version_string(), subtitle_color);
 
         ImGui::Spacing();
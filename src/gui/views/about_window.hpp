@@ -1,13 +1,13 @@
 #ifndef CLRSYNC_GUI_ABOUT_WINDOW_HPP
 #define CLRSYNC_GUI_ABOUT_WINDOW_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 
 class about_window
 {
   public:
     about_window();
-    void render(const clrsync::core::palette &pal);
+    void render(const clrsync::gui::widgets::resolved_palette &pal);
     void render()
     {
         render(m_default_palette);
@@ -27,7 +27,7 @@ class about_window
 
   private:
     bool m_visible{false};
-    clrsync::core::palette m_default_palette;
+    clrsync::gui::widgets::resolved_palette m_default_palette;
 };
 
 #endif // CLRSYNC_GUI_ABOUT_WINDOW_HPP
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "color_scheme_editor.hpp"
+#include "core/config/config.hpp"
 #include "gui/controllers/theme_applier.hpp"
 #include "gui/widgets/dialogs.hpp"
 #include "gui/widgets/palette_selector.hpp"
@@ -11,39 +12,81 @@
 
 color_scheme_editor::color_scheme_editor()
 {
-    const auto &current = m_controller.current_palette();
+    setup_subscribers();
+    set_sync_rate(clrsync::core::config::instance().snapshot()->gui_sync_hz);
 
-    if (!current.colors().empty())
+    if (!m_controller.current_palette().colors().empty())
     {
-        theme_applier::apply_to_imgui(current);
-        m_preview.apply_palette(current);
+        apply_themes();
     }
     else
     {
         std::cout << "WARNING: No palette loaded, skipping theme application\n";
     }
-    
+
     setup_widgets();
 }
 
-void color_scheme_editor::notify_palette_changed()
+void color_scheme_editor::setup_subscribers()
 {
-    if (m_template_editor)
-    {
-        m_template_editor->apply_current_palette(m_controller.current_palette());
-    }
-    if (m_settings_window)
-    {
-        m_settings_window->set_palette(m_controller.current_palette());
-    }
+    using key_set = palette_change_bus::key_set;
+
+    m_changes.subscribe(
+        palette_change_bus::keys({"background", "on_background", "surface", "on_surface",
+                                  "surface_variant", "on_surface_variant", "foreground",
+                                  "editor_inactive", "border", "accent", "success", "info",
+                                  "warning", "error", "on_success", "on_info", "on_warning",
+                                  "on_error"}),
+        [](const clrsync::core::palette &pal, const key_set &) {
+            theme_applier::apply_to_imgui(pal);
+        });
+
+    m_changes.subscribe(
+        palette_change_bus::keys({"editor_main", "editor_command", "editor_warning",
+                                  "editor_string", "editor_emphasis", "editor_link",
+                                  "editor_comment", "editor_background", "cursor",
+                                  "editor_selected", "editor_error", "editor_line_number",
+                                  "surface_variant", "surface", "border_focused"}),
+        [this](const clrsync::core::palette &pal, const key_set &) {
+            m_preview.apply_palette(pal);
+        });
+
+    // These rebuild everything they draw from the palette, so they trail a dragged picker.
+    m_changes.subscribe(
+        palette_change_bus::all_keys(),
+        [this](const clrsync::core::palette &, const key_set &) {
+            // The shared palette itself, so the preview can tell an unchanged one apart.
+            if (m_template_editor)
+                m_template_editor->apply_current_palette(m_controller.current_palette_ptr());
+        },
+        true);
+    m_changes.subscribe(
+        palette_change_bus::all_keys(),
+        [this](const clrsync::core::palette &, const key_set &) {
+            if (m_settings_window)
+                m_settings_window->set_palette(m_controller.resolved_palette());
+        },
+        true);
+}
+
+void color_scheme_editor::set_sync_rate(uint32_t hz)
+{
+    palette_change_bus::clock::duration interval{};
+    if (hz > 0)
+        interval = std::chrono::duration_cast<palette_change_bus::clock::duration>(
+                       std::chrono::seconds(1)) / hz;
+    m_changes.set_throttle_interval(interval);
+}
+
+void color_scheme_editor::reload_palettes()
+{
+    m_controller.reload_from_config([this]() { apply_themes(); });
 }
 
 void color_scheme_editor::apply_themes()
 {
-    const auto &current = m_controller.current_palette();
-    theme_applier::apply_to_imgui(current);
-    m_preview.apply_palette(current);
-    notify_palette_changed();
+    m_changes.mark_all_changed();
+    m_changes.flush(m_controller.current_palette());
 }
 
 void color_scheme_editor::render_controls_and_colors()
@@ -55,9 +98,13 @@ void color_scheme_editor::render_controls_and_colors()
 
     ImGui::BeginChild("ColorTableContent", ImVec2(0, 0), false);
     m_color_table.render(m_controller.current_palette(), m_controller,
-                         [this]() { apply_themes(); });
+                         [this](const char *key) { m_changes.mark_changed(key); });
     ImGui::EndChild();
 
+    // Once per frame however many colors changed, and every frame after the last edit too,
+    // so throttled views catch up.
+    m_changes.flush(m_controller.current_palette());
+
     ImGui::End();
 }
 
@@ -65,7 +112,7 @@ void color_scheme_editor::render_preview()
 {
     ImGui::Begin("Color Preview");
 
-    m_preview.render(m_controller.current_palette());
+    m_preview.render(m_controller.resolved_palette());
 
     ImGui::End();
 }
@@ -97,7 +144,13 @@ void color_scheme_editor::render_controls()
     m_new_palette_dialog.render();
 
     ImGui::SameLine();
-    m_action_buttons.render(current);
+    m_action_buttons.render(m_controller.resolved_palette());
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(180);
+    ImGui::InputTextWithHint("##apply_only", "All templates", m_apply_only, sizeof(m_apply_only));
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Limit Apply Theme to these comma-separated template names or tags");
 
     if (m_show_delete_confirmation)
     {
@@ -106,9 +159,9 @@ void color_scheme_editor::render_controls()
     }
 
     clrsync::gui::widgets::delete_confirmation_dialog("Delete Palette?", current.name(), "palette",
-                                                    current, [this]() {
-                                                        m_controller.delete_current_palette();
-                                                        apply_themes();
+                                                    m_controller.resolved_palette(), [this]() {
+                                                        m_controller.delete_current_palette(
+                                                            [this]() { apply_themes(); });
                                                     });
 
     ImGui::PopStyleVar(2);
@@ -122,9 +175,7 @@ void color_scheme_editor::setup_widgets()
     });
     
     m_new_palette_dialog.set_on_submit([this](const std::string &name) {
-        m_controller.create_palette(name);
-        m_controller.select_palette(name);
-        apply_themes();
+        m_controller.create_palette(name, [this]() { apply_themes(); });
     });
     
     m_action_buttons.add_button({
@@ -143,8 +194,11 @@ void color_scheme_editor::setup_widgets()
     
     m_action_buttons.add_button({
         " Apply Theme ",
-        "Apply current palette to all enabled templates",
-        [this]() { m_controller.apply_current_theme(); }
+        "Apply current palette to the enabled templates",
+        [this]() {
+            m_controller.apply_current_theme(
+                clrsync::core::template_filter::from_lists(m_apply_only, {}));
+        }
     });
     
     m_action_buttons.set_spacing(16.0f);
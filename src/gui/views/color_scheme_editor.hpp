@@ -1,6 +1,7 @@
 #ifndef CLRSYNC_GUI_COLOR_SCHEME_EDITOR_HPP
 #define CLRSYNC_GUI_COLOR_SCHEME_EDITOR_HPP
 
+#include "gui/controllers/palette_change_bus.hpp"
 #include "gui/controllers/palette_controller.hpp"
 #include "gui/views/color_table_renderer.hpp"
 #include "gui/views/preview_renderer.hpp"
@@ -30,19 +31,37 @@ class color_scheme_editor
     {
         return m_controller;
     }
+    void reload_palettes();
+    // Saving, deleting, reloading and applying palettes run on these jobs.
+    void set_job_queue(job_queue *jobs)
+    {
+        m_controller.set_job_queue(jobs);
+    }
+    // Updates per second the template editor and settings window get while a color is
+    // being dragged; 0 updates them every frame.
+    void set_sync_rate(uint32_t hz);
+    // True while a throttled view has not caught up with the palette yet, so the caller
+    // must keep rendering frames.
+    bool has_pending_changes() const
+    {
+        return m_changes.has_pending();
+    }
 
   private:
     void render_controls();
     void apply_themes();
-    void notify_palette_changed();
     void setup_widgets();
+    void setup_subscribers();
 
     palette_controller m_controller;
+    palette_change_bus m_changes;
     color_table_renderer m_color_table;
     preview_renderer m_preview;
     template_editor *m_template_editor{nullptr};
     settings_window *m_settings_window{nullptr};
     bool m_show_delete_confirmation{false};
+    // Comma-separated template names or tags "Apply Theme" is limited to; empty applies all.
+    char m_apply_only[128] = {0};
     
     clrsync::gui::widgets::palette_selector m_palette_selector;
     clrsync::gui::widgets::input_dialog m_new_palette_dialog;
@@ -3,87 +3,129 @@
 #include "imgui.h"
 #include <algorithm>
 #include <cctype>
-#include <vector>
+#include <cstdio>
+#include <initializer_list>
 
-bool color_table_renderer::matches_filter(const std::string &name) const
+namespace
 {
-    if (m_filter_text[0] == '\0')
-        return true;
+std::string to_lower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+} // namespace
 
-    std::string filter_lower = m_filter_text;
-    std::string name_lower = name;
+color_table_renderer::color_table_renderer()
+{
+    auto add_section = [this](const char *title, const char *id,
+                              std::initializer_list<const char *> keys) {
+        section sec{title, id, {}, {}};
+        sec.rows.reserve(keys.size());
+        for (const char *key : keys)
+            sec.rows.push_back(row{key, to_lower(key), {0}, 0, true});
+        m_sections.push_back(std::move(sec));
+    };
 
-    std::transform(filter_lower.begin(), filter_lower.end(), filter_lower.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    std::transform(name_lower.begin(), name_lower.end(), name_lower.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
+    add_section("General UI", "##general_ui",
+                {"background", "on_background", "surface", "on_surface", "surface_variant",
+                 "on_surface_variant", "foreground", "cursor", "accent"});
 
-    return name_lower.find(filter_lower) != std::string::npos;
+    add_section("Borders", "##borders", {"border_focused", "border"});
+
+    add_section(
+        "Semantic Colors", "##semantic",
+        {"success", "info", "warning", "error", "on_success", "on_info", "on_warning", "on_error"});
+
+    add_section("Editor", "##editor",
+                {"editor_background", "editor_command", "editor_comment", "editor_disabled",
+                 "editor_emphasis", "editor_error", "editor_inactive", "editor_line_number",
+                 "editor_link", "editor_main", "editor_selected", "editor_selection_inactive",
+                 "editor_string", "editor_success", "editor_warning"});
+
+    add_section("Terminal (Base16)", "##terminal",
+                {"base00", "base01", "base02", "base03", "base04", "base05", "base06", "base07",
+                 "base08", "base09", "base0A", "base0B", "base0C", "base0D", "base0E", "base0F"});
+
+    update_matches();
 }
 
-void color_table_renderer::render_color_row(const std::string &name,
-                                            const clrsync::core::palette &current,
+void color_table_renderer::update_matches()
+{
+    m_filter_lower = to_lower(m_filter_text);
+    for (auto &sec : m_sections)
+    {
+        sec.matches.clear();
+        for (int i = 0; i < static_cast<int>(sec.rows.size()); ++i)
+        {
+            if (sec.rows[i].lower_name.find(m_filter_lower) != std::string::npos)
+                sec.matches.push_back(i);
+        }
+    }
+}
+
+void color_table_renderer::render_color_row(row &item, const clrsync::core::palette &current,
                                             palette_controller &controller,
                                             const OnColorChangedCallback &on_changed)
 {
-    if (!matches_filter(name))
-        return;
-
-    const clrsync::core::color &col = current.get_color(name);
+    const clrsync::core::color &col = current.get_color(item.name);
+    if (item.hex_stale || item.hex_value != col.hex())
+    {
+        std::snprintf(item.hex, sizeof(item.hex), "#%06X", col.hex() >> 8);
+        item.hex_value = col.hex();
+        item.hex_stale = false;
+    }
 
     ImGui::TableNextRow();
+    ImGui::PushID(item.name);
 
     ImGui::TableSetColumnIndex(0);
     const float key_col_width = ImGui::GetContentRegionAvail().x;
 
-    ImVec4 text_color = clrsync::gui::widgets::palette_color(current, "info", "accent");
+    ImVec4 text_color = controller.resolved_palette().color("info", "accent");
     ImGui::PushStyleColor(ImGuiCol_Text, text_color);
-    const bool copied = ImGui::Selectable(name.c_str(), false, 0, ImVec2(key_col_width, 0.0f));
+    const bool copied = ImGui::Selectable(item.name, false, 0, ImVec2(key_col_width, 0.0f));
     ImGui::PopStyleColor();
 
     if (ImGui::IsItemHovered())
     {
         ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
-        ImGui::SetTooltip("Click to copy: {%s.hex}", name.c_str());
+        ImGui::SetTooltip("Click to copy: {%s.hex}", item.name);
     }
     if (copied)
     {
-        std::string template_var = "{" + name + ".hex}";
+        std::string template_var = std::string("{") + item.name + ".hex}";
         ImGui::SetClipboardText(template_var.c_str());
     }
 
     ImGui::TableSetColumnIndex(1);
     {
-        std::string hex_str = col.to_hex_string();
-        char buf[9];
-        strncpy(buf, hex_str.c_str(), sizeof(buf));
-        buf[8] = 0;
-
         ImGui::SetNextItemWidth(-FLT_MIN);
-        if (ImGui::InputText(("##hex_" + name).c_str(), buf, sizeof(buf),
+        if (ImGui::InputText("##hex", item.hex, sizeof(item.hex),
                              ImGuiInputTextFlags_CharsUppercase))
         {
             try
             {
                 clrsync::core::color new_color;
-                new_color.from_hex_string(buf);
-                controller.set_color(name, new_color);
+                new_color.from_hex_string(item.hex);
+                controller.set_color(item.name, new_color);
                 if (on_changed)
-                    on_changed();
+                    on_changed(item.name);
             }
             catch (...)
             {
+                // Show the stored color again once the field is left, as before the cache.
+                item.hex_stale = true;
             }
         }
     }
 
     ImGui::TableSetColumnIndex(2);
-    ImGui::PushID(name.c_str());
     float c[4] = {((col.hex() >> 24) & 0xFF) / 255.0f, ((col.hex() >> 16) & 0xFF) / 255.0f,
                   ((col.hex() >> 8) & 0xFF) / 255.0f, (col.hex() & 0xFF) / 255.0f};
 
     ImGui::SetNextItemWidth(-FLT_MIN);
-    if (ImGui::ColorEdit4(("##color_" + name).c_str(), c,
+    if (ImGui::ColorEdit4("##color", c,
                           ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel |
                               ImGuiColorEditFlags_AlphaBar | ImGuiColorEditFlags_AlphaPreviewHalf))
     {
@@ -93,21 +135,62 @@ void color_table_renderer::render_color_row(const std::string &name,
         uint32_t a = (uint32_t)(c[3] * 255.0f);
         uint32_t hex = (r << 24) | (g << 16) | (b << 8) | a;
 
-        controller.set_color(name, clrsync::core::color(hex));
+        controller.set_color(item.name, clrsync::core::color(hex));
         if (on_changed)
-            on_changed();
+            on_changed(item.name);
     }
 
     ImGui::PopID();
 }
 
+void color_table_renderer::render_section(section &sec, const clrsync::core::palette &current,
+                                          palette_controller &controller,
+                                          const OnColorChangedCallback &on_changed)
+{
+    if (sec.matches.empty())
+        return;
+
+    ImGui::PushStyleColor(ImGuiCol_Text, controller.resolved_palette().color("accent"));
+    bool header_open = ImGui::TreeNodeEx(sec.title, ImGuiTreeNodeFlags_DefaultOpen |
+                                                        ImGuiTreeNodeFlags_SpanAvailWidth);
+    ImGui::PopStyleColor();
+
+    if (header_open)
+    {
+        if (ImGui::BeginTable(sec.id, 3,
+                              ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                  ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthFixed, 160.0f);
+            ImGui::TableSetupColumn("HEX", ImGuiTableColumnFlags_WidthFixed, 95.0f);
+            ImGui::TableSetupColumn("Color", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+
+            // Every row has the same widgets, hence the same height, so only the rows inside
+            // the scrolled view are submitted.
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(sec.matches.size()));
+            while (clipper.Step())
+            {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                    render_color_row(sec.rows[sec.matches[i]], current, controller, on_changed);
+            }
+
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+
+    ImGui::Spacing();
+}
+
 void color_table_renderer::render(const clrsync::core::palette &current,
                                   palette_controller &controller,
                                   const OnColorChangedCallback &on_changed)
 {
     if (current.colors().empty())
     {
-        ImVec4 warning_color = clrsync::gui::widgets::palette_color(current, "warning", "accent");
+        ImVec4 warning_color = controller.resolved_palette().color("warning", "accent");
         ImGui::TextColored(warning_color, "No palette loaded");
         return;
     }
@@ -138,69 +221,13 @@ void color_table_renderer::render(const clrsync::core::palette &current,
 
     ImGui::PopStyleVar();
 
+    if (filter_changed)
+        update_matches();
+
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
 
-    auto draw_table = [&](const char *title, const char *id,
-                          const std::vector<const char *> &keys) {
-        bool has_matches = false;
-        for (auto *k : keys)
-        {
-            if (matches_filter(k))
-            {
-                has_matches = true;
-                break;
-            }
-        }
-
-        if (!has_matches)
-            return;
-
-        ImGui::PushStyleColor(ImGuiCol_Text, clrsync::gui::widgets::palette_color(current, "accent"));
-        bool header_open = ImGui::TreeNodeEx(title, ImGuiTreeNodeFlags_DefaultOpen |
-                                                        ImGuiTreeNodeFlags_SpanAvailWidth);
-        ImGui::PopStyleColor();
-
-        if (header_open)
-        {
-            if (ImGui::BeginTable(id, 3,
-                                  ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
-                                      ImGuiTableFlags_SizingStretchProp))
-            {
-                ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthFixed, 160.0f);
-                ImGui::TableSetupColumn("HEX", ImGuiTableColumnFlags_WidthFixed, 95.0f);
-                ImGui::TableSetupColumn("Color", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableHeadersRow();
-
-                for (auto *k : keys)
-                    render_color_row(k, current, controller, on_changed);
-
-                ImGui::EndTable();
-            }
-            ImGui::TreePop();
-        }
-
-        ImGui::Spacing();
-    };
-
-    draw_table("General UI", "##general_ui",
-               {"background", "on_background", "surface", "on_surface", "surface_variant",
-                "on_surface_variant", "foreground", "cursor", "accent"});
-
-    draw_table("Borders", "##borders", {"border_focused", "border"});
-
-    draw_table(
-        "Semantic Colors", "##semantic",
-        {"success", "info", "warning", "error", "on_success", "on_info", "on_warning", "on_error"});
-
-    draw_table("Editor", "##editor",
-               {"editor_background", "editor_command", "editor_comment", "editor_disabled",
-                "editor_emphasis", "editor_error", "editor_inactive", "editor_line_number",
-                "editor_link", "editor_main", "editor_selected", "editor_selection_inactive",
-                "editor_string", "editor_success", "editor_warning"});
-
-    draw_table("Terminal (Base16)", "##terminal",
-               {"base00", "base01", "base02", "base03", "base04", "base05", "base06", "base07",
-                "base08", "base09", "base0A", "base0B", "base0C", "base0D", "base0E", "base0F"});
+    for (auto &sec : m_sections)
+        render_section(sec, current, controller, on_changed);
 }
@@ -3,24 +3,53 @@
 
 #include "core/palette/palette.hpp"
 #include "gui/controllers/palette_controller.hpp"
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 class color_table_renderer
 {
   public:
-    using OnColorChangedCallback = std::function<void()>;
+    // Called with the key of each color edited.
+    using OnColorChangedCallback = std::function<void(const char *key)>;
+
+    color_table_renderer();
 
     void render(const clrsync::core::palette &palette, palette_controller &controller,
                 const OnColorChangedCallback &on_changed);
 
   private:
-    void render_color_row(const std::string &name, const clrsync::core::palette &palette,
+    // Everything a row needs that does not change from frame to frame.
+    struct row
+    {
+        const char *name;
+        std::string lower_name;
+        // The hex field's text, reformatted only when the color changes.
+        char hex[9];
+        uint32_t hex_value;
+        bool hex_stale;
+    };
+
+    struct section
+    {
+        const char *title;
+        const char *id;
+        std::vector<row> rows;
+        // Indices into rows that match the filter.
+        std::vector<int> matches;
+    };
+
+    void render_section(section &sec, const clrsync::core::palette &palette,
+                        palette_controller &controller, const OnColorChangedCallback &on_changed);
+    void render_color_row(row &r, const clrsync::core::palette &palette,
                           palette_controller &controller, const OnColorChangedCallback &on_changed);
 
-    bool matches_filter(const std::string &name) const;
+    void update_matches();
 
+    std::vector<section> m_sections;
     char m_filter_text[128] = {0};
+    std::string m_filter_lower;
     bool m_show_only_modified{false};
 };
 
@@ -72,12 +72,6 @@ int main()
     m_editor.SetShowWhitespaces(false);
 }
 
-static ImVec4 hex_to_imvec4(uint32_t hex)
-{
-    return {((hex >> 24) & 0xFF) / 255.0f, ((hex >> 16) & 0xFF) / 255.0f,
-            ((hex >> 8) & 0xFF) / 255.0f, (hex & 0xFF) / 255.0f};
-}
-
 void preview_renderer::apply_palette(const clrsync::core::palette &palette)
 {
     theme_applier::apply_to_editor(m_editor, palette);
@@ -94,12 +88,10 @@ void preview_renderer::render_code_preview()
     m_editor.Render("##CodeEditor", ImVec2(0, code_preview_height), true);
 }
 
-void preview_renderer::render_terminal_preview(const clrsync::core::palette &current)
+void preview_renderer::render_terminal_preview(
+    const clrsync::gui::widgets::resolved_palette &current)
 {
-    auto get_color = [&](const std::string &key) -> ImVec4 {
-        const auto &col = current.get_color(key);
-        return hex_to_imvec4(col.hex());
-    };
+    auto get_color = [&](clrsync::core::color_key key) { return current.color_or_default(key); };
     const ImVec4 bg = get_color("base00");
     const ImVec4 fg = get_color("base07");
     const ImVec4 cursor_col = get_color("cursor");
@@ -232,11 +224,11 @@ void preview_renderer::render_terminal_preview(const clrsync::core::palette &cur
     ImGui::EndChild();
 }
 
-void preview_renderer::render(const clrsync::core::palette &current)
+void preview_renderer::render(const clrsync::gui::widgets::resolved_palette &current)
 {
-    if (current.colors().empty())
+    if (current.empty())
     {
-        ImVec4 error_color = clrsync::gui::widgets::palette_color(current, "error", "accent");
+        ImVec4 error_color = current.color("error", "accent");
         ImGui::TextColored(error_color, "Current palette is empty");
         return;
     }
@@ -3,18 +3,19 @@
 
 #include "color_text_edit/TextEditor.h"
 #include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 
 class preview_renderer
 {
   public:
     preview_renderer();
 
-    void render(const clrsync::core::palette &palette);
+    void render(const clrsync::gui::widgets::resolved_palette &palette);
     void apply_palette(const clrsync::core::palette &palette);
 
   private:
     void render_code_preview();
-    void render_terminal_preview(const clrsync::core::palette &palette);
+    void render_terminal_preview(const clrsync::gui::widgets::resolved_palette &palette);
 
     TextEditor m_editor;
 };
@@ -133,9 +133,12 @@ void settings_window::apply_settings()
         return;
     }
 
+    cfg.begin();
+
     auto result1 = cfg.set_default_theme(m_default_theme);
     if (!result1)
     {
+        cfg.rollback();
         m_error.set("Failed to set default theme: " + result1.error().description());
         return;
     }
@@ -143,6 +146,7 @@ void settings_window::apply_settings()
     auto result2 = cfg.set_palettes_path(m_palettes_path);
     if (!result2)
     {
+        cfg.rollback();
         m_error.set("Failed to set palettes path: " + result2.error().description());
         return;
     }
@@ -150,6 +154,7 @@ void settings_window::apply_settings()
     auto result3 = cfg.set_font(m_font);
     if (!result3)
     {
+        cfg.rollback();
         m_error.set("Failed to set font: " + result3.error().description());
         return;
     }
@@ -157,10 +162,18 @@ void settings_window::apply_settings()
     auto result4 = cfg.set_font_size(m_font_size);
     if (!result4)
     {
+        cfg.rollback();
         m_error.set("Failed to set font size: " + result4.error().description());
         return;
     }
 
+    auto commit_result = cfg.commit();
+    if (!commit_result)
+    {
+        m_error.set("Failed to save settings: " + commit_result.error().description());
+        return;
+    }
+
     if (m_ui_manager && !m_ui_manager->reload_font(m_font.c_str(), m_font_size))
     {
         m_error.set("Failed to load font: " + m_font);
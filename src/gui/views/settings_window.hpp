@@ -1,7 +1,7 @@
 #ifndef CLRSYNC_GUI_SETTINGS_WINDOW_HPP
 #define CLRSYNC_GUI_SETTINGS_WINDOW_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 #include "gui/widgets/error_message.hpp"
 #include "gui/widgets/form_field.hpp"
 #include "gui/widgets/settings_buttons.hpp"
@@ -22,7 +22,10 @@ class settings_window
     void hide() { m_visible = false; }
     bool is_visible() const { return m_visible; }
 
-    void set_palette(const clrsync::core::palette& palette) { m_current_palette = palette; }
+    void set_palette(const clrsync::gui::widgets::resolved_palette& palette)
+    {
+        m_current_palette = palette;
+    }
 
   private:
     void load_settings();
@@ -43,7 +46,7 @@ class settings_window
 
     std::vector<std::string> m_available_fonts;
 
-    clrsync::core::palette m_current_palette;
+    clrsync::gui::widgets::resolved_palette m_current_palette;
     clrsync::gui::ui_manager* m_ui_manager;
 
     clrsync::gui::widgets::form_field m_form;
@@ -6,6 +6,7 @@
 #include "gui/widgets/colors.hpp"
 #include "gui/widgets/dialogs.hpp"
 #include "gui/ui_manager.hpp"
+#include "gui/views/template_syntax.hpp"
 #include "imgui.h"
 #include <algorithm>
 #include <filesystem>
@@ -14,40 +15,25 @@
 
 namespace
 {
-const std::vector<std::string> COLOR_FORMATS = {
-    "hex", "hex_stripped", "hexa", "hexa_stripped", "r", "g", "b", "a", "rgb", "rgba", "h", "s",
-    "l",   "hsl",          "hsla"};
+std::vector<std::string> color_key_names()
+{
+    return {std::begin(clrsync::core::COLOR_KEYS), std::end(clrsync::core::COLOR_KEYS)};
+}
+
+// Trailing newlines are not a change: the editor and the file disagree on the last one.
+uint64_t content_hash(std::string_view text)
+{
+    size_t end = text.find_last_not_of("\r\n");
+    return clrsync::core::fnv1a64(end == std::string_view::npos ? "" : text.substr(0, end + 1));
 }
+} // namespace
 
 template_editor::template_editor(clrsync::gui::ui_manager* ui_mgr)
-    : m_ui_manager(ui_mgr)
+    : m_autocomplete(color_key_names(), clrsync::gui::COLOR_FORMATS), m_ui_manager(ui_mgr)
 {
     m_control_state.name = "new_template";
 
-    m_autocomplete_bg_color = ImVec4(0.12f, 0.12f, 0.15f, 0.98f);
-    m_autocomplete_border_color = ImVec4(0.4f, 0.4f, 0.45f, 1.0f);
-    m_autocomplete_selected_color = ImVec4(0.25f, 0.45f, 0.75f, 0.9f);
-    m_autocomplete_text_color = ImVec4(0.85f, 0.85f, 0.9f, 1.0f);
-    m_autocomplete_selected_text_color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
-    m_autocomplete_dim_text_color = ImVec4(0.6f, 0.6f, 0.7f, 1.0f);
-
-    TextEditor::LanguageDefinition lang;
-    lang.mName = "Template";
-
-    lang.mCommentStart = "/*";
-    lang.mCommentEnd = "*/";
-    lang.mSingleLineComment = "#";
-
-    lang.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>(
-        "\\{[a-zA-Z_][a-zA-Z0-9_]*(\\.[a-zA-Z_][a-zA-Z0-9_]*)?\\}",
-        TextEditor::PaletteIndex::KnownIdentifier));
-
-    lang.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>(
-        "\"([^\"]*)\"", TextEditor::PaletteIndex::String));
-    lang.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>(
-        "'([^']*)'", TextEditor::PaletteIndex::String));
-
-    m_editor.SetLanguageDefinition(lang);
+    m_editor.SetLanguageDefinition(clrsync::gui::template_language());
     m_editor.SetText("# Enter your template here\n# Use {color_key} for color variables\n# "
                      "Examples: {color.hex}, {color.rgb}, {color.r}\n\n");
     m_editor.SetShowWhitespaces(false);
@@ -80,14 +66,15 @@ void template_editor::setup_callbacks()
     };
 }
 
-void template_editor::apply_current_palette(const clrsync::core::palette &pal)
+void template_editor::apply_current_palette(const clrsync::core::palette_ptr &pal)
 {
-    m_current_palette = pal;
-    auto colors = pal.colors();
-    if (colors.empty())
+    m_current_palette = clrsync::gui::widgets::resolved_palette(*pal);
+    m_preview.set_palette(pal);
+    if (m_current_palette.empty())
         return;
-    auto get_color_u32 = [&](const std::string &key, const std::string &fallback = "") -> uint32_t {
-        return clrsync::gui::widgets::palette_color_u32(pal, key, fallback);
+    auto get_color_u32 = [&](clrsync::core::color_key key,
+                             clrsync::core::color_key fallback = {}) -> uint32_t {
+        return m_current_palette.color_u32(key, fallback);
     };
 
     auto palette = m_editor.GetPalette();
@@ -130,236 +117,7 @@ void template_editor::apply_current_palette(const clrsync::core::palette &pal)
 
     m_editor.SetPalette(palette);
 
-    m_autocomplete_bg_color = clrsync::gui::widgets::palette_color(pal, "surface", "background");
-    m_autocomplete_bg_color.w = 0.98f;
-    m_autocomplete_border_color = clrsync::gui::widgets::palette_color(pal, "border", "surface_variant");
-    m_autocomplete_selected_color = clrsync::gui::widgets::palette_color(pal, "accent", "surface_variant");
-    m_autocomplete_text_color = clrsync::gui::widgets::palette_color(pal, "on_surface", "foreground");
-    m_autocomplete_selected_text_color = clrsync::gui::widgets::palette_color(pal, "on_surface", "foreground");
-    m_autocomplete_dim_text_color =
-        clrsync::gui::widgets::palette_color(pal, "on_surface_variant", "editor_inactive");
-}
-
-void template_editor::update_autocomplete_suggestions()
-{
-    m_autocomplete_suggestions.clear();
-
-    auto cursor = m_editor.GetCursorPosition();
-    std::string line = m_editor.GetCurrentLineText();
-    int col = cursor.mColumn;
-
-    // Check if inside '{'
-    int brace_pos = -1;
-    for (int i = col - 1; i >= 0; --i)
-    {
-        if (i < (int)line.length())
-        {
-            if (line[i] == '{')
-            {
-                brace_pos = i;
-                break;
-            }
-            else if (line[i] == '}' || line[i] == ' ' || line[i] == '\t')
-            {
-                break;
-            }
-        }
-    }
-
-    if (brace_pos < 0)
-    {
-        m_show_autocomplete = false;
-        m_autocomplete_dismissed = false;
-        return;
-    }
-
-    if (m_autocomplete_dismissed)
-    {
-        bool should_reset_dismissal = false;
-
-        if (cursor.mLine != m_dismiss_position.mLine || brace_pos != m_dismiss_brace_pos ||
-            abs(cursor.mColumn - m_dismiss_position.mColumn) > 3)
-        {
-            should_reset_dismissal = true;
-        }
-
-        if (should_reset_dismissal)
-        {
-            m_autocomplete_dismissed = false;
-        }
-        else
-        {
-            m_show_autocomplete = false;
-            return;
-        }
-    }
-
-    m_autocomplete_prefix = line.substr(brace_pos + 1, col - brace_pos - 1);
-    m_autocomplete_start_pos = TextEditor::Coordinates(cursor.mLine, brace_pos + 1);
-
-    size_t dot_pos = m_autocomplete_prefix.find('.');
-
-    if (dot_pos != std::string::npos)
-    {
-        std::string color_key = m_autocomplete_prefix.substr(0, dot_pos);
-        std::string format_prefix = m_autocomplete_prefix.substr(dot_pos + 1);
-
-        bool valid_key = false;
-        for (size_t i = 0; i < clrsync::core::NUM_COLOR_KEYS; ++i)
-        {
-            if (clrsync::core::COLOR_KEYS[i] == color_key)
-            {
-                valid_key = true;
-                break;
-            }
-        }
-
-        if (valid_key)
-        {
-            for (const auto &fmt : COLOR_FORMATS)
-            {
-                if (format_prefix.empty() || fmt.find(format_prefix) == 0 ||
-                    fmt.find(format_prefix) != std::string::npos)
-                {
-                    m_autocomplete_suggestions.push_back(color_key + "." + fmt);
-                }
-            }
-        }
-    }
-    else
-    {
-        for (size_t i = 0; i < clrsync::core::NUM_COLOR_KEYS; ++i)
-        {
-            std::string key = clrsync::core::COLOR_KEYS[i];
-            if (m_autocomplete_prefix.empty() || key.find(m_autocomplete_prefix) == 0 ||
-                key.find(m_autocomplete_prefix) != std::string::npos)
-            {
-                m_autocomplete_suggestions.push_back(key);
-            }
-        }
-    }
-
-    std::sort(m_autocomplete_suggestions.begin(), m_autocomplete_suggestions.end(),
-              [this](const std::string &a, const std::string &b) {
-                  bool a_prefix = a.find(m_autocomplete_prefix) == 0;
-                  bool b_prefix = b.find(m_autocomplete_prefix) == 0;
-                  if (a_prefix != b_prefix)
-                      return a_prefix;
-                  return a < b;
-              });
-
-    m_show_autocomplete = !m_autocomplete_suggestions.empty();
-    if (m_show_autocomplete && m_autocomplete_selected >= (int)m_autocomplete_suggestions.size())
-    {
-        m_autocomplete_selected = 0;
-    }
-}
-
-void template_editor::render_autocomplete(const ImVec2 &editor_pos)
-{
-    if (!m_show_autocomplete || m_autocomplete_suggestions.empty())
-        return;
-
-    float line_height = ImGui::GetTextLineHeightWithSpacing();
-    float char_width = ImGui::GetFontSize() * 0.5f;
-    auto cursor = m_editor.GetCursorPosition();
-
-    const float line_number_width = 50.0f;
-
-    ImVec2 popup_pos;
-    popup_pos.x =
-        editor_pos.x + line_number_width + (m_autocomplete_start_pos.mColumn * char_width);
-    popup_pos.y = editor_pos.y + ((cursor.mLine + 1) * line_height);
-
-    ImGui::SetNextWindowPos(popup_pos, ImGuiCond_Always);
-    ImGui::SetNextWindowSize(ImVec2(300, 0));
-
-    ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
-                             ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings |
-                             ImGuiWindowFlags_NoFocusOnAppearing |
-                             ImGuiWindowFlags_AlwaysAutoResize;
-
-    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(6, 6));
-    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 6.0f);
-    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 2));
-    ImGui::PushStyleColor(ImGuiCol_WindowBg, m_autocomplete_bg_color);
-    ImGui::PushStyleColor(ImGuiCol_Border, m_autocomplete_border_color);
-
-    if (ImGui::Begin("##autocomplete", nullptr, flags))
-    {
-        ImGui::PushStyleColor(ImGuiCol_Text, m_autocomplete_dim_text_color);
-        if (m_autocomplete_prefix.find('.') != std::string::npos)
-            ImGui::Text("Formats");
-        else
-            ImGui::Text("Color Keys");
-        ImGui::PopStyleColor();
-        ImGui::Separator();
-
-        int max_items = std::min((int)m_autocomplete_suggestions.size(), 8);
-
-        for (int i = 0; i < max_items; ++i)
-        {
-            const auto &suggestion = m_autocomplete_suggestions[i];
-            bool is_selected = (i == m_autocomplete_selected);
-
-            if (is_selected)
-            {
-                ImVec4 selected_hover = m_autocomplete_selected_color;
-                selected_hover.w = std::min(selected_hover.w + 0.1f, 1.0f);
-                ImGui::PushStyleColor(ImGuiCol_Header, m_autocomplete_selected_color);
-                ImGui::PushStyleColor(ImGuiCol_HeaderHovered, selected_hover);
-                ImGui::PushStyleColor(ImGuiCol_Text, m_autocomplete_selected_text_color);
-            }
-            else
-            {
-                ImVec4 normal_bg = m_autocomplete_bg_color;
-                normal_bg.w = 0.5f;
-                ImVec4 hover_bg = m_autocomplete_selected_color;
-                hover_bg.w = 0.3f;
-                ImGui::PushStyleColor(ImGuiCol_Header, normal_bg);
-                ImGui::PushStyleColor(ImGuiCol_HeaderHovered, hover_bg);
-                ImGui::PushStyleColor(ImGuiCol_Text, m_autocomplete_text_color);
-            }
-
-            std::string display_text = "  " + suggestion;
-
-            if (ImGui::Selectable(display_text.c_str(), is_selected, ImGuiSelectableFlags_None,
-                                  ImVec2(0, 0)))
-            {
-                auto start = m_autocomplete_start_pos;
-                auto end = m_editor.GetCursorPosition();
-                m_editor.SetSelection(start, end);
-                m_editor.Delete();
-                m_editor.InsertText(suggestion + "}");
-                m_show_autocomplete = false;
-                m_autocomplete_dismissed = false;
-            }
-
-            ImGui::PopStyleColor(3);
-
-            if (is_selected && ImGui::IsWindowAppearing())
-            {
-                ImGui::SetScrollHereY();
-            }
-        }
-
-        if (m_autocomplete_suggestions.size() > 8)
-        {
-            ImGui::Separator();
-            ImGui::PushStyleColor(ImGuiCol_Text, m_autocomplete_dim_text_color);
-            ImGui::Text("  +%d more", (int)m_autocomplete_suggestions.size() - 8);
-            ImGui::PopStyleColor();
-        }
-
-        ImGui::Separator();
-        ImGui::PushStyleColor(ImGuiCol_Text, m_autocomplete_dim_text_color);
-        ImGui::Text("  Tab/Enter: accept | Esc: dismiss");
-        ImGui::PopStyleColor();
-    }
-    ImGui::End();
-
-    ImGui::PopStyleColor(2);
-    ImGui::PopStyleVar(3);
+    m_autocomplete.apply_palette(m_current_palette);
 }
 
 void template_editor::render()
@@ -379,10 +137,20 @@ void template_editor::render()
 
     ImGui::SameLine();
 
-    ImGui::BeginChild("EditorPanel", ImVec2(right_panel_width, 0), false);
+    const float editor_width =
+        m_show_preview ? (right_panel_width - 10) * 0.5f : right_panel_width;
+    ImGui::BeginChild("EditorPanel", ImVec2(editor_width, 0), false);
     render_editor();
     ImGui::EndChild();
 
+    if (m_show_preview)
+    {
+        ImGui::SameLine();
+        ImGui::BeginChild("PreviewPanel", ImVec2(0, 0), false);
+        render_preview();
+        ImGui::EndChild();
+    }
+
     if (m_show_delete_confirmation)
     {
         ImGui::OpenPopup("Delete Template?");
@@ -423,7 +191,7 @@ void template_editor::render_editor()
 
     if (!m_control_state.is_editing_existing)
     {
-        ImVec4 success_color = clrsync::gui::widgets::palette_color(m_current_palette, "success", "accent");
+        ImVec4 success_color = m_current_palette.color("success", "accent");
         ImGui::PushStyleColor(ImGuiCol_Text, success_color);
         ImGui::Text("  New Template");
         ImGui::PopStyleColor();
@@ -431,77 +199,24 @@ void template_editor::render_editor()
     else
     {
         ImGui::Text("  %s", m_control_state.name.c_str());
-        auto trim_right = [](const std::string &s) -> std::string {
-            size_t end = s.find_last_not_of("\r\n");
-            return (end == std::string::npos) ? "" : s.substr(0, end + 1);
-        };
-
-        std::string current_content = trim_right(m_editor.GetText());
-        std::string saved_content = trim_right(m_saved_content);
-
-        m_has_unsaved_changes = (current_content != saved_content);
-        if (m_has_unsaved_changes)
+        if (has_unsaved_changes())
         {
             ImGui::SameLine();
-            ImVec4 warning_color = clrsync::gui::widgets::palette_color(m_current_palette, "warning", "accent");
+            ImVec4 warning_color = m_current_palette.color("warning", "accent");
             ImGui::PushStyleColor(ImGuiCol_Text, warning_color);
             ImGui::Text("(unsaved)");
             ImGui::PopStyleColor();
         }
     }
 
+    ImGui::SameLine(ImGui::GetContentRegionMax().x - ImGui::CalcTextSize("Preview").x -
+                    ImGui::GetFrameHeight() - ImGui::GetStyle().ItemInnerSpacing.x);
+    ImGui::Checkbox("Preview", &m_show_preview);
+
     ImGui::PopStyleVar();
     ImGui::Separator();
 
-    bool consume_keys = false;
-
-    if (m_show_autocomplete && ImGui::IsKeyPressed(ImGuiKey_Escape, false))
-    {
-        m_show_autocomplete = false;
-        m_autocomplete_dismissed = true;
-
-        m_dismiss_position = m_editor.GetCursorPosition();
-
-        std::string line = m_editor.GetCurrentLineText();
-        m_dismiss_brace_pos = -1;
-        for (int i = m_dismiss_position.mColumn - 1; i >= 0; --i)
-        {
-            if (i < (int)line.length() && line[i] == '{')
-            {
-                m_dismiss_brace_pos = i;
-                break;
-            }
-        }
-
-        consume_keys = true;
-    }
-    else if (m_show_autocomplete && !m_autocomplete_suggestions.empty())
-    {
-        int max_visible = std::min((int)m_autocomplete_suggestions.size(), 8);
-
-        if (ImGui::IsKeyPressed(ImGuiKey_DownArrow, false))
-        {
-            m_autocomplete_selected = (m_autocomplete_selected + 1) % max_visible;
-            consume_keys = true;
-        }
-        else if (ImGui::IsKeyPressed(ImGuiKey_UpArrow, false))
-        {
-            m_autocomplete_selected = (m_autocomplete_selected - 1 + max_visible) % max_visible;
-            consume_keys = true;
-        }
-        else if (ImGui::IsKeyPressed(ImGuiKey_Tab, false) ||
-                 ImGui::IsKeyPressed(ImGuiKey_Enter, false))
-        {
-            auto start = m_autocomplete_start_pos;
-            auto end = m_editor.GetCursorPosition();
-            m_editor.SetSelection(start, end);
-            m_editor.Delete();
-            m_editor.InsertText(m_autocomplete_suggestions[m_autocomplete_selected] + "}");
-            m_show_autocomplete = false;
-            m_autocomplete_dismissed = false;
-            consume_keys = true;
-        }
-    }
+    bool consume_keys = m_autocomplete.handle_input(m_editor);
 
     if (consume_keys)
     {
@@ -517,8 +232,68 @@ void template_editor::render_editor()
         m_editor.SetHandleKeyboardInputs(true);
     }
 
-    update_autocomplete_suggestions();
-    render_autocomplete(editor_pos);
+    m_autocomplete.update_suggestions(m_editor);
+    m_autocomplete.render(editor_pos, m_editor);
+}
+
+void template_editor::render_preview()
+{
+    m_preview.update(m_editor);
+    if (m_preview.waiting())
+        m_ui_manager->request_redraw();
+
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8, 4));
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("  Preview");
+    ImGui::PopStyleVar();
+    ImGui::Separator();
+
+    ImGui::PushStyleColor(ImGuiCol_ChildBg,
+                          m_current_palette.color("editor_background", "background"));
+    ImGui::BeginChild("##TemplatePreview", ImVec2(0, 0), true,
+                      ImGuiWindowFlags_HorizontalScrollbar);
+
+    const auto &lines = m_preview.lines();
+    const ImU32 text_color = m_current_palette.color_u32("editor_main", "foreground");
+    const ImU32 error_color = m_current_palette.color_u32("editor_error", "error");
+    const float line_height = ImGui::GetTextLineHeight();
+    ImDrawList *draw_list = ImGui::GetWindowDrawList();
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(lines.size()), ImGui::GetTextLineHeightWithSpacing());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto &item = *lines[i];
+            const char *text = item.text.c_str();
+            const ImVec2 start = ImGui::GetCursorScreenPos();
+            ImVec2 pos = start;
+            auto draw_text = [&](size_t from, size_t to, ImU32 color) {
+                if (from >= to)
+                    return;
+                draw_list->AddText(pos, color, text + from, text + to);
+                pos.x += ImGui::CalcTextSize(text + from, text + to).x;
+            };
+
+            const ImU32 plain = item.failed ? error_color : text_color;
+            size_t at = 0;
+            for (const auto &value : item.highlights)
+            {
+                draw_text(at, value.begin, plain);
+                const float width = ImGui::CalcTextSize(text + value.begin, text + value.end).x;
+                draw_list->AddRectFilled(pos, ImVec2(pos.x + width, pos.y + line_height),
+                                         value.fill, 2.0f);
+                draw_text(value.begin, value.end, value.text);
+                at = value.end;
+            }
+            draw_text(at, item.text.size(), plain);
+            ImGui::Dummy(ImVec2(pos.x - start.x, line_height));
+        }
+    }
+
+    ImGui::EndChild();
+    ImGui::PopStyleColor();
 }
 
 void template_editor::render_template_list()
@@ -532,7 +307,7 @@ void template_editor::render_template_list()
 
     if (!m_control_state.is_editing_existing)
     {
-        ImVec4 success_color = clrsync::gui::widgets::palette_color(m_current_palette, "success", "accent");
+        ImVec4 success_color = m_current_palette.color("success", "accent");
         ImVec4 success_bg = ImVec4(success_color.x, success_color.y, success_color.z, 0.5f);
         ImGui::PushStyleColor(ImGuiCol_Text, success_color);
         ImGui::PushStyleColor(ImGuiCol_Header, success_bg);
@@ -549,8 +324,8 @@ void template_editor::render_template_list()
 
         if (!tmpl.enabled())
         {
-            ImVec4 disabled_color = clrsync::gui::widgets::palette_color(
-                m_current_palette, "on_surface_variant", "editor_inactive");
+            ImVec4 disabled_color =
+                m_current_palette.color("on_surface_variant", "editor_inactive");
             ImGui::PushStyleColor(ImGuiCol_Text, disabled_color);
         }
 
@@ -713,12 +488,34 @@ void template_editor::save_template()
     m_control_state.input_path = trimmed_input_path;
     m_control_state.output_path = trimmed_path;
     m_control_state.is_editing_existing = true;
-    m_saved_content = m_editor.GetText();
-    m_has_unsaved_changes = false;
+    mark_saved(template_content);
 
     refresh_templates();
 }
 
+void template_editor::mark_saved(const std::string &content)
+{
+    m_editor.MarkClean();
+    m_saved_hash = content_hash(content);
+    m_checked_generation = m_editor.GetEditGeneration();
+    m_has_unsaved_changes = false;
+}
+
+bool template_editor::has_unsaved_changes()
+{
+    // Only look at the text when it changed, and only hash it once the undo history has lost
+    // the saved state, e.g. after an autocomplete insert.
+    const uint64_t generation = m_editor.GetEditGeneration();
+    if (generation == m_checked_generation)
+        return m_has_unsaved_changes;
+    m_checked_generation = generation;
+    if (m_editor.HasCleanMark())
+        m_has_unsaved_changes = !m_editor.IsClean();
+    else
+        m_has_unsaved_changes = content_hash(m_editor.GetText()) != m_saved_hash;
+    return m_has_unsaved_changes;
+}
+
 void template_editor::load_template(const std::string &name)
 {
     const auto &templates = m_template_controller.templates();
@@ -747,8 +544,7 @@ void template_editor::load_template(const std::string &name)
             in.close();
 
             m_editor.SetText(content);
-            m_saved_content = content;
-            m_has_unsaved_changes = false;
+            mark_saved(content);
         }
         else
         {
@@ -764,14 +560,13 @@ void template_editor::new_template()
         "# Enter your template here\n# Use {color_key} for color variables\n# "
         "Examples: {color.hex}, {color.rgb}, {color.r}\n\n";
     m_editor.SetText(default_content);
-    m_saved_content = default_content;
+    mark_saved(default_content);
     m_control_state.input_path = "";
     m_control_state.output_path = "";
     m_control_state.reload_command = "";
     m_control_state.enabled = true;
     m_control_state.is_editing_existing = false;
     m_validation.clear();
-    m_has_unsaved_changes = false;
 }
 
 void template_editor::delete_template()
@@ -0,0 +1,174 @@
+#include "template_syntax.hpp"
+#include "core/palette/color_keys.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <unordered_set>
+
+namespace clrsync::gui
+{
+const std::vector<std::string> COLOR_FORMATS = {
+    "hex", "hex_stripped", "hexa", "hexa_stripped", "r", "g", "b", "a", "rgb", "rgba", "h", "s",
+    "l",   "hsl",          "hsla"};
+
+namespace
+{
+using PaletteIndex = TextEditor::PaletteIndex;
+
+bool is_identifier_start(char c)
+{
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_identifier(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_known_key(std::string_view key)
+{
+    static const std::unordered_set<std::string_view> keys(std::begin(core::COLOR_KEYS),
+                                                           std::end(core::COLOR_KEYS));
+    return keys.count(key) != 0;
+}
+
+bool is_known_format(std::string_view format)
+{
+    static const std::unordered_set<std::string_view> formats = [] {
+        std::unordered_set<std::string_view> set(COLOR_FORMATS.begin(), COLOR_FORMATS.end());
+        // Not offered, but color::format() still accepts it.
+        set.insert("hsla_a");
+        return set;
+    }();
+    return formats.count(format) != 0;
+}
+
+// Reads an identifier starting at `p`; returns its end, or `p` if there is none.
+const char *scan_identifier(const char *p, const char *end)
+{
+    if (p == end || !is_identifier_start(*p))
+        return p;
+    while (p < end && is_identifier(*p))
+        ++p;
+    return p;
+}
+
+// "{key}" or "{key.format}" at `begin`. Other braces belong to the output's own syntax, e.g.
+// CSS blocks, and are left alone. Returns the end of the placeholder, or nullptr.
+const char *scan_placeholder(const char *begin, const char *end, bool &known)
+{
+    const char *key = begin + 1;
+    const char *p = scan_identifier(key, end);
+    if (p == key || p == end)
+        return nullptr;
+    known = is_known_key(std::string_view(key, p - key));
+
+    if (*p == '.')
+    {
+        const char *format = p + 1;
+        p = scan_identifier(format, end);
+        if (p == format || p == end)
+            return nullptr;
+        known = known && is_known_format(std::string_view(format, p - format));
+    }
+    return *p == '}' ? p + 1 : nullptr;
+}
+
+void paint(PaletteIndex *colors, size_t from, size_t to, PaletteIndex index)
+{
+    std::fill(colors + from, colors + to, index);
+}
+
+// Strings and block comments only count when they close on the same line, so no state
+// carries over between lines.
+void tokenize_line(const char *begin, const char *end, PaletteIndex *colors)
+{
+    char quote = '\0';
+    for (const char *p = begin; p < end;)
+    {
+        const size_t at = p - begin;
+
+        // Placeholders are substituted inside strings too, so they keep their own color there.
+        bool known = false;
+        if (*p == '{')
+        {
+            if (const char *placeholder_end = scan_placeholder(p, end, known))
+            {
+                paint(colors, at, placeholder_end - begin,
+                      known ? PaletteIndex::KnownIdentifier : PaletteIndex::ErrorMarker);
+                p = placeholder_end;
+                continue;
+            }
+        }
+
+        if (quote != '\0')
+        {
+            colors[at] = PaletteIndex::String;
+            if (*p == quote)
+                quote = '\0';
+            ++p;
+            continue;
+        }
+
+        if ((*p == '"' || *p == '\'') && std::find(p + 1, end, *p) != end)
+        {
+            quote = *p;
+            colors[at] = PaletteIndex::String;
+            ++p;
+            continue;
+        }
+
+        if (*p == '/' && p + 1 < end && p[1] == '*')
+        {
+            const std::string_view rest(p + 2, end - p - 2);
+            const auto close = rest.find("*/");
+            const char *comment_end = close == std::string_view::npos ? end : p + 2 + close + 2;
+            paint(colors, at, comment_end - begin, PaletteIndex::MultiLineComment);
+            p = comment_end;
+            continue;
+        }
+
+        if (*p == '#')
+        {
+            // "#{background.hex_stripped}": the placeholder is the color.
+            if (p + 1 < end && p[1] == '{')
+            {
+                ++p;
+                continue;
+            }
+
+            const char *digits_end = p + 1;
+            while (digits_end < end && std::isxdigit(static_cast<unsigned char>(*digits_end)))
+                ++digits_end;
+            const auto digits = digits_end - p - 1;
+            if ((digits == 3 || digits == 4 || digits == 6 || digits == 8) &&
+                (digits_end == end || !is_identifier(*digits_end)))
+            {
+                paint(colors, at, digits_end - begin, PaletteIndex::Number);
+                p = digits_end;
+                continue;
+            }
+
+            paint(colors, at, end - begin, PaletteIndex::Comment);
+            break;
+        }
+
+        ++p;
+    }
+}
+} // namespace
+
+const TextEditor::LanguageDefinition &template_language()
+{
+    static const TextEditor::LanguageDefinition definition = [] {
+        TextEditor::LanguageDefinition lang;
+        lang.mName = "Template";
+        // Comments are tokens too: with no comment or preprocessor syntax declared, the
+        // editor never rescans the whole text after an edit.
+        lang.mPreprocChar = '\0';
+        lang.mTokenizeLine = tokenize_line;
+        return lang;
+    }();
+    return definition;
+}
+} // namespace clrsync::gui
@@ -0,0 +1,23 @@
+#ifndef CLRSYNC_GUI_TEMPLATE_SYNTAX_HPP
+#define CLRSYNC_GUI_TEMPLATE_SYNTAX_HPP
+
+#include "color_text_edit/TextEditor.h"
+#include <string>
+#include <vector>
+
+namespace clrsync::gui
+{
+// Formats offered after "{key.".
+extern const std::vector<std::string> COLOR_FORMATS;
+
+// Highlighting for templates, tokenized by hand rather than with regexes:
+//   {key} {key.format}  known identifier, or the error color if the key or format is unknown
+//   #1e1e2e             number
+//   # ...               comment to the end of the line
+//   "..." '...'         string, if it closes on the same line; placeholders inside keep their color
+//   /* ... */           comment, up to the end of the line if it does not close there
+// Everything is line-local, so an edit only recolors the lines it touched.
+const TextEditor::LanguageDefinition &template_language();
+} // namespace clrsync::gui
+
+#endif // CLRSYNC_GUI_TEMPLATE_SYNTAX_HPP
@@ -17,7 +17,7 @@ void action_buttons::clear()
     m_buttons.clear();
 }
 
-void action_buttons::render(const core::palette &theme_palette)
+void action_buttons::render(const resolved_palette &theme_palette)
 {
     if (m_buttons.empty())
         return;
@@ -40,10 +40,10 @@ void action_buttons::render(const core::palette &theme_palette)
         int style_colors_pushed = 0;
         if (button.use_error_style)
         {
-            auto error = palette_color(theme_palette, "error");
+            auto error = theme_palette.color("error");
             auto error_hover = ImVec4(error.x * 1.1f, error.y * 1.1f, error.z * 1.1f, error.w);
             auto error_active = ImVec4(error.x * 0.8f, error.y * 0.8f, error.z * 0.8f, error.w);
-            auto on_error = palette_color(theme_palette, "on_error");
+            auto on_error = theme_palette.color("on_error");
             ImGui::PushStyleColor(ImGuiCol_Button, error);
             ImGui::PushStyleColor(ImGuiCol_ButtonHovered, error_hover);
             ImGui::PushStyleColor(ImGuiCol_ButtonActive, error_active);
@@ -52,10 +52,10 @@ void action_buttons::render(const core::palette &theme_palette)
         }
         else if (button.use_success_style)
         {
-            auto success = palette_color(theme_palette, "success", "accent");
+            auto success = theme_palette.color("success", "accent");
             auto success_hover = ImVec4(success.x * 1.1f, success.y * 1.1f, success.z * 1.1f, success.w);
             auto success_active = ImVec4(success.x * 0.8f, success.y * 0.8f, success.z * 0.8f, success.w);
-            auto on_success = palette_color(theme_palette, "on_success", "on_surface");
+            auto on_success = theme_palette.color("on_success", "on_surface");
             ImGui::PushStyleColor(ImGuiCol_Button, success);
             ImGui::PushStyleColor(ImGuiCol_ButtonHovered, success_hover);
             ImGui::PushStyleColor(ImGuiCol_ButtonActive, success_active);
@@ -1,7 +1,7 @@
 #ifndef CLRSYNC_GUI_WIDGETS_ACTION_BUTTONS_HPP
 #define CLRSYNC_GUI_WIDGETS_ACTION_BUTTONS_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 #include <functional>
 #include <string>
 #include <vector>
@@ -29,7 +29,7 @@ class action_buttons
 
     void clear();
 
-    void render(const core::palette &theme_palette);
+    void render(const resolved_palette &theme_palette);
 
     void set_spacing(float spacing) { m_spacing = spacing; }
 
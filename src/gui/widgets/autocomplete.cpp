@@ -1,47 +1,159 @@
 #include "autocomplete.hpp"
-#include "colors.hpp"
 #include "imgui.h"
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
 namespace clrsync::gui::widgets
 {
 
-autocomplete_widget::autocomplete_widget() 
-    : m_selected_index(0), m_show_autocomplete(false), m_dismissed(false), m_dismiss_brace_pos(-1)
+namespace
 {
-    m_bg_color = ImVec4(0.12f, 0.12f, 0.15f, 0.98f);
-    m_border_color = ImVec4(0.4f, 0.4f, 0.45f, 1.0f);
-    m_selected_color = ImVec4(0.25f, 0.45f, 0.75f, 0.9f);
-    m_text_color = ImVec4(0.85f, 0.85f, 0.9f, 1.0f);
-    m_selected_text_color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
-    m_dim_text_color = ImVec4(0.6f, 0.6f, 0.7f, 1.0f);
+char lower(char c)
+{
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+// Score of `pattern` as a subsequence of `name`, or -1 if it is not one. Matches at the start,
+// at word starts and right after the previous match score higher; skipped characters cost.
+int fuzzy_score(std::string_view pattern, std::string_view name)
+{
+    int score = 0;
+    size_t at = 0;
+    bool adjacent = false;
+    for (char c : pattern)
+    {
+        c = lower(c);
+        while (at < name.size() && lower(name[at]) != c)
+        {
+            --score;
+            adjacent = false;
+            ++at;
+        }
+        if (at == name.size())
+            return -1;
+
+        score += 1;
+        if (at == 0)
+            score += 8;
+        else if (name[at - 1] == '_' || name[at - 1] == '.')
+            score += 4;
+        if (adjacent)
+            score += 5;
+        adjacent = true;
+        ++at;
+    }
+    return score;
+}
+} // namespace
+
+completion_index::completion_index(const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &formats)
+    : m_num_keys(keys.size()), m_num_formats(formats.size())
+{
+    m_entries.reserve(keys.size() * (formats.size() + 1));
+    for (const auto &key : keys)
+        m_entries.push_back({key, 0});
+    for (const auto &key : keys)
+        for (const auto &format : formats)
+            m_entries.push_back({key + "." + format, key.size() + 1});
+
+    // Views into m_entries, which no longer moves.
+    for (size_t i = 0; i < m_num_keys; ++i)
+        m_key_index.emplace(m_entries[i].text, i);
 }
 
-void autocomplete_widget::update_suggestions(const TextEditor& editor, 
-                                            const std::vector<std::string>& available_keys,
-                                            const std::vector<std::string>& available_formats)
+const std::vector<size_t> &completion_index::match(std::string_view query)
 {
-    m_suggestions.clear();
+    if (query == m_query && !m_query.empty())
+        return m_matches;
+
+    size_t scope_begin = 0;
+    size_t scope_end = m_num_keys;
+    std::string_view pattern = query;
+    size_t dot = query.find('.');
+    if (dot != std::string_view::npos)
+    {
+        auto it = m_key_index.find(query.substr(0, dot));
+        scope_begin = scope_end = m_entries.size();
+        if (it != m_key_index.end())
+        {
+            scope_begin = m_num_keys + it->second * m_num_formats;
+            scope_end = scope_begin + m_num_formats;
+        }
+        pattern = query.substr(dot + 1);
+    }
+
+    // Every match of a longer pattern is a match of its prefix.
+    std::vector<size_t> candidates;
+    if (scope_begin == m_scope_begin && scope_end == m_scope_end && !m_query.empty() &&
+        pattern.substr(0, m_pattern.size()) == m_pattern)
+    {
+        candidates.swap(m_matches);
+    }
+    else
+    {
+        candidates.reserve(scope_end - scope_begin);
+        for (size_t i = scope_begin; i < scope_end; ++i)
+            candidates.push_back(i);
+    }
 
+    std::vector<std::pair<int, size_t>> scored;
+    scored.reserve(candidates.size());
+    for (size_t i : candidates)
+    {
+        const auto &candidate = m_entries[i];
+        int score = fuzzy_score(pattern,
+                                std::string_view(candidate.text).substr(candidate.name_offset));
+        if (score >= 0)
+            scored.emplace_back(score, i);
+    }
+    std::sort(scored.begin(), scored.end(), [this](const auto &a, const auto &b) {
+        if (a.first != b.first)
+            return a.first > b.first;
+        return m_entries[a.second].text < m_entries[b.second].text;
+    });
+
+    m_matches.clear();
+    for (const auto &[score, i] : scored)
+        m_matches.push_back(i);
+    m_query = query;
+    m_pattern = pattern;
+    m_scope_begin = scope_begin;
+    m_scope_end = scope_end;
+    return m_matches;
+}
+
+autocomplete_widget::autocomplete_widget(const std::vector<std::string> &keys,
+                                         const std::vector<std::string> &formats)
+    : m_index(keys, formats)
+{
+}
+
+void autocomplete_widget::update_suggestions(const TextEditor &editor)
+{
     auto cursor = editor.GetCursorPosition();
+    const uint64_t generation = editor.GetEditGeneration();
+    if (cursor == m_last_cursor && generation == m_last_generation)
+        return;
+    m_last_cursor = cursor;
+    m_last_generation = generation;
+
     std::string line = editor.GetCurrentLineText();
     int col = cursor.mColumn;
 
     // Check if inside '{'
     int brace_pos = -1;
-    for (int i = col - 1; i >= 0; --i)
+    for (int i = std::min(col, (int)line.length()) - 1; i >= 0; --i)
     {
-        if (i < (int)line.length())
+        if (line[i] == '{')
         {
-            if (line[i] == '{')
-            {
-                brace_pos = i;
-                break;
-            }
-            else if (line[i] == '}' || line[i] == ' ' || line[i] == '\t')
-            {
-                break;
-            }
+            brace_pos = i;
+            break;
+        }
+        else if (line[i] == '}' || line[i] == ' ' || line[i] == '\t')
+        {
+            break;
         }
     }
 
@@ -54,15 +166,8 @@ void autocomplete_widget::update_suggestions(const TextEditor& editor,
 
     if (m_dismissed)
     {
-        bool should_reset_dismissal = false;
-
         if (cursor.mLine != m_dismiss_position.mLine || brace_pos != m_dismiss_brace_pos ||
             abs(cursor.mColumn - m_dismiss_position.mColumn) > 3)
-        {
-            should_reset_dismissal = true;
-        }
-
-        if (should_reset_dismissal)
         {
             m_dismissed = false;
         }
@@ -73,61 +178,21 @@ void autocomplete_widget::update_suggestions(const TextEditor& editor,
         }
     }
 
-    m_prefix = line.substr(brace_pos + 1, col - brace_pos - 1);
+    std::string prefix = line.substr(brace_pos + 1, col - brace_pos - 1);
+    if (prefix != m_prefix)
+        m_selected_index = 0;
+    m_prefix = std::move(prefix);
     m_start_pos = TextEditor::Coordinates(cursor.mLine, brace_pos + 1);
 
-    size_t dot_pos = m_prefix.find('.');
-
-    if (dot_pos != std::string::npos)
-    {
-        std::string color_key = m_prefix.substr(0, dot_pos);
-        std::string format_prefix = m_prefix.substr(dot_pos + 1);
-
-        bool valid_key = std::find(available_keys.begin(), available_keys.end(), color_key) != available_keys.end();
-
-        if (valid_key)
-        {
-            for (const auto &fmt : available_formats)
-            {
-                if (format_prefix.empty() || fmt.find(format_prefix) == 0 ||
-                    fmt.find(format_prefix) != std::string::npos)
-                {
-                    m_suggestions.push_back(color_key + "." + fmt);
-                }
-            }
-        }
-    }
-    else
-    {
-        for (const auto& key : available_keys)
-        {
-            if (m_prefix.empty() || key.find(m_prefix) == 0 ||
-                key.find(m_prefix) != std::string::npos)
-            {
-                m_suggestions.push_back(key);
-            }
-        }
-    }
-
-    std::sort(m_suggestions.begin(), m_suggestions.end(),
-              [this](const std::string &a, const std::string &b) {
-                  bool a_prefix = a.find(m_prefix) == 0;
-                  bool b_prefix = b.find(m_prefix) == 0;
-                  if (a_prefix != b_prefix)
-                      return a_prefix;
-                  return a < b;
-              });
-
-    m_show_autocomplete = !m_suggestions.empty();
-    if (m_show_autocomplete && m_selected_index >= (int)m_suggestions.size())
-    {
+    m_show_autocomplete = !m_index.match(m_prefix).empty();
+    if (m_selected_index >= visible_count())
         m_selected_index = 0;
-    }
 }
 
-void autocomplete_widget::render(const ImVec2& editor_pos, TextEditor& editor)
+void autocomplete_widget::render(const ImVec2 &editor_pos, TextEditor &editor)
 {
-    if (!m_show_autocomplete || m_suggestions.empty())
+    const auto &suggestions = m_index.matches();
+    if (!m_show_autocomplete || suggestions.empty())
         return;
 
     float line_height = ImGui::GetTextLineHeightWithSpacing();
@@ -164,11 +229,10 @@ void autocomplete_widget::render(const ImVec2& editor_pos, TextEditor& editor)
         ImGui::PopStyleColor();
         ImGui::Separator();
 
-        int max_items = std::min((int)m_suggestions.size(), 8);
-
+        const int max_items = visible_count();
         for (int i = 0; i < max_items; ++i)
         {
-            const auto &suggestion = m_suggestions[i];
+            const size_t suggestion = suggestions[i];
             bool is_selected = (i == m_selected_index);
 
             if (is_selected)
@@ -190,17 +254,12 @@ void autocomplete_widget::render(const ImVec2& editor_pos, TextEditor& editor)
                 ImGui::PushStyleColor(ImGuiCol_Text, m_text_color);
             }
 
-            std::string display_text = "  " + suggestion;
+            std::string display_text = "  " + m_index.entry(suggestion);
 
-            if (ImGui::Selectable(display_text.c_str(), is_selected, ImGuiSelectableFlags_None, ImVec2(0, 0)))
+            if (ImGui::Selectable(display_text.c_str(), is_selected, ImGuiSelectableFlags_None,
+                                  ImVec2(0, 0)))
             {
-                auto start = m_start_pos;
-                auto end = editor.GetCursorPosition();
-                editor.SetSelection(start, end);
-                editor.Delete();
-                editor.InsertText(suggestion + "}");
-                m_show_autocomplete = false;
-                m_dismissed = false;
+                accept(editor, suggestion);
             }
 
             ImGui::PopStyleColor(3);
@@ -211,11 +270,11 @@ void autocomplete_widget::render(const ImVec2& editor_pos, TextEditor& editor)
             }
         }
 
-        if (m_suggestions.size() > 8)
+        if (suggestions.size() > MAX_VISIBLE)
         {
             ImGui::Separator();
             ImGui::PushStyleColor(ImGuiCol_Text, m_dim_text_color);
-            ImGui::Text("  +%d more", (int)m_suggestions.size() - 8);
+            ImGui::Text("  +%d more", (int)suggestions.size() - MAX_VISIBLE);
             ImGui::PopStyleColor();
         }
 
@@ -230,58 +289,67 @@ void autocomplete_widget::render(const ImVec2& editor_pos, TextEditor& editor)
     ImGui::PopStyleVar(3);
 }
 
-void autocomplete_widget::apply_palette(const core::palette& palette)
+void autocomplete_widget::apply_palette(const resolved_palette &palette)
 {
-    m_bg_color = palette_color(palette, "surface", "background");
+    m_bg_color = palette.color("surface", "background");
     m_bg_color.w = 0.98f;
-    m_border_color = palette_color(palette, "border", "surface_variant");
-    m_selected_color = palette_color(palette, "accent", "surface_variant");
-    m_text_color = palette_color(palette, "on_surface", "foreground");
-    m_selected_text_color = palette_color(palette, "on_surface", "foreground");
-    m_dim_text_color = palette_color(palette, "on_surface_variant", "editor_inactive");
+    m_border_color = palette.color("border", "surface_variant");
+    m_selected_color = palette.color("accent", "surface_variant");
+    m_text_color = palette.color("on_surface", "foreground");
+    m_selected_text_color = palette.color("on_surface", "foreground");
+    m_dim_text_color = palette.color("on_surface_variant", "editor_inactive");
 }
 
-bool autocomplete_widget::handle_input(TextEditor& editor)
+bool autocomplete_widget::handle_input(TextEditor &editor)
 {
-    if (!m_show_autocomplete || m_suggestions.empty())
+    if (!m_show_autocomplete)
         return false;
 
-    bool handled = false;
-
-    if (ImGui::IsKeyPressed(ImGuiKey_DownArrow))
+    if (ImGui::IsKeyPressed(ImGuiKey_Escape, false))
     {
-        m_selected_index = (m_selected_index + 1) % (int)m_suggestions.size();
-        handled = true;
+        m_dismissed = true;
+        m_dismiss_position = editor.GetCursorPosition();
+        m_dismiss_brace_pos = m_start_pos.mColumn - 1;
+        m_show_autocomplete = false;
+        return true;
     }
-    else if (ImGui::IsKeyPressed(ImGuiKey_UpArrow))
+
+    const int max_visible = visible_count();
+    if (max_visible == 0)
+        return false;
+
+    if (ImGui::IsKeyPressed(ImGuiKey_DownArrow, false))
     {
-        m_selected_index = (m_selected_index - 1 + (int)m_suggestions.size()) % (int)m_suggestions.size();
-        handled = true;
+        m_selected_index = (m_selected_index + 1) % max_visible;
+        return true;
     }
-    else if (ImGui::IsKeyPressed(ImGuiKey_Tab) || ImGui::IsKeyPressed(ImGuiKey_Enter))
+    if (ImGui::IsKeyPressed(ImGuiKey_UpArrow, false))
     {
-        if (m_selected_index >= 0 && m_selected_index < (int)m_suggestions.size())
-        {
-            auto start = m_start_pos;
-            auto end = editor.GetCursorPosition();
-            editor.SetSelection(start, end);
-            editor.Delete();
-            editor.InsertText(m_suggestions[m_selected_index] + "}");
-            m_show_autocomplete = false;
-            m_dismissed = false;
-        }
-        handled = true;
+        m_selected_index = (m_selected_index - 1 + max_visible) % max_visible;
+        return true;
     }
-    else if (ImGui::IsKeyPressed(ImGuiKey_Escape))
+    if (ImGui::IsKeyPressed(ImGuiKey_Tab, false) || ImGui::IsKeyPressed(ImGuiKey_Enter, false))
     {
-        m_dismissed = true;
-        m_dismiss_position = editor.GetCursorPosition();
-        m_dismiss_brace_pos = -1;
-        m_show_autocomplete = false;
-        handled = true;
+        accept(editor, m_index.matches()[m_selected_index]);
+        return true;
     }
+    return false;
+}
 
-    return handled;
+int autocomplete_widget::visible_count() const
+{
+    return std::min((int)m_index.matches().size(), MAX_VISIBLE);
+}
+
+void autocomplete_widget::accept(TextEditor &editor, size_t entry)
+{
+    auto start = m_start_pos;
+    auto end = editor.GetCursorPosition();
+    editor.SetSelection(start, end);
+    editor.Delete();
+    editor.InsertText(m_index.entry(entry) + "}");
+    m_show_autocomplete = false;
+    m_dismissed = false;
 }
 
-} // namespace clrsync::gui::widgets
\ No newline at end of file
+} // namespace clrsync::gui::widgets
@@ -1,53 +1,119 @@
 #ifndef CLRSYNC_GUI_WIDGETS_AUTOCOMPLETE_HPP
 #define CLRSYNC_GUI_WIDGETS_AUTOCOMPLETE_HPP
 
-#include "core/palette/palette.hpp"
 #include "color_text_edit/TextEditor.h"
+#include "gui/widgets/colors.hpp"
 #include "imgui.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace clrsync::gui::widgets
 {
 
+// Placeholder completions, built once: every key, and "key.format" for every key and format.
+// Queries match as subsequences ("bgv" finds "background_variant") and are ranked by how well
+// they match. A query that extends the previous one only rescans the previous matches.
+class completion_index
+{
+  public:
+    completion_index(const std::vector<std::string> &keys,
+                     const std::vector<std::string> &formats);
+
+    // Completes what follows a '{': keys, or after "key." the formats of that key. Returns
+    // entry indices, best first.
+    const std::vector<size_t> &match(std::string_view query);
+
+    const std::vector<size_t> &matches() const
+    {
+        return m_matches;
+    }
+
+    const std::string &entry(size_t index) const
+    {
+        return m_entries[index].text;
+    }
+
+  private:
+    struct item
+    {
+        std::string text;
+        // Where the part a query is matched against starts: 0 for keys, past the dot for
+        // formats.
+        size_t name_offset{0};
+    };
+
+    std::vector<item> m_entries;
+    size_t m_num_keys{0};
+    size_t m_num_formats{0};
+    std::unordered_map<std::string_view, size_t> m_key_index;
+
+    std::string m_query;
+    size_t m_scope_begin{0};
+    size_t m_scope_end{0};
+    std::string m_pattern;
+    std::vector<size_t> m_matches;
+};
+
 class autocomplete_widget
 {
   public:
-    autocomplete_widget();
+    autocomplete_widget(const std::vector<std::string> &keys,
+                        const std::vector<std::string> &formats);
 
-    void update_suggestions(const TextEditor& editor, 
-                           const std::vector<std::string>& available_keys,
-                           const std::vector<std::string>& available_formats);
+    // Looks at the text around the cursor; does nothing unless the cursor moved or the text
+    // changed since the last call.
+    void update_suggestions(const TextEditor &editor);
 
-    void render(const ImVec2& editor_pos, TextEditor& editor);
+    void render(const ImVec2 &editor_pos, TextEditor &editor);
 
-    void apply_palette(const core::palette& palette);
+    void apply_palette(const resolved_palette &palette);
 
-    bool handle_input(TextEditor& editor);
+    // Handles navigation keys while suggestions are shown. Returns true if it used a key this
+    // frame; keep the editor's keyboard handling off for that frame.
+    bool handle_input(TextEditor &editor);
 
-    bool is_visible() const { return m_show_autocomplete; }
+    bool is_visible() const
+    {
+        return m_show_autocomplete;
+    }
 
-    void dismiss() { m_dismissed = true; m_show_autocomplete = false; }
+    void dismiss()
+    {
+        m_dismissed = true;
+        m_show_autocomplete = false;
+    }
 
   private:
-    std::vector<std::string> m_suggestions;
+    static constexpr int MAX_VISIBLE = 8;
+
+    completion_index m_index;
     std::string m_prefix;
     TextEditor::Coordinates m_start_pos;
-    int m_selected_index;
-    bool m_show_autocomplete;
-    bool m_dismissed;
-    
+    int m_selected_index{0};
+    bool m_show_autocomplete{false};
+    bool m_dismissed{false};
+
+    // What the suggestions were computed for; the generation starts out matching no text.
+    TextEditor::Coordinates m_last_cursor;
+    uint64_t m_last_generation{UINT64_MAX};
+
     TextEditor::Coordinates m_dismiss_position;
-    int m_dismiss_brace_pos;
-    
-    ImVec4 m_bg_color;
-    ImVec4 m_border_color;
-    ImVec4 m_selected_color;
-    ImVec4 m_text_color;
-    ImVec4 m_selected_text_color;
-    ImVec4 m_dim_text_color;
+    int m_dismiss_brace_pos{-1};
+
+    ImVec4 m_bg_color{0.12f, 0.12f, 0.15f, 0.98f};
+    ImVec4 m_border_color{0.4f, 0.4f, 0.45f, 1.0f};
+    ImVec4 m_selected_color{0.25f, 0.45f, 0.75f, 0.9f};
+    ImVec4 m_text_color{0.85f, 0.85f, 0.9f, 1.0f};
+    ImVec4 m_selected_text_color{1.0f, 1.0f, 1.0f, 1.0f};
+    ImVec4 m_dim_text_color{0.6f, 0.6f, 0.7f, 1.0f};
+
+    int visible_count() const;
+    void accept(TextEditor &editor, size_t entry);
 };
 
 } // namespace clrsync::gui::widgets
 
-#endif // CLRSYNC_GUI_WIDGETS_AUTOCOMPLETE_HPP
\ No newline at end of file
+#endif // CLRSYNC_GUI_WIDGETS_AUTOCOMPLETE_HPP
@@ -1,58 +1,117 @@
 #include "colors.hpp"
+#include <unordered_map>
 
 namespace clrsync::gui::widgets
 {
 
-ImVec4 palette_color(const core::palette &pal, const std::string &key,
-                     const std::string &fallback)
+namespace
 {
-    auto colors = pal.colors();
-    if (colors.empty())
-        return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+const ImVec4 WHITE(1.0f, 1.0f, 1.0f, 1.0f);
+
+// RRGGBBAA to normalized RGBA.
+ImVec4 to_imvec4(uint32_t hex)
+{
+    return ImVec4(((hex >> 24) & 0xFF) / 255.0f, ((hex >> 16) & 0xFF) / 255.0f,
+                  ((hex >> 8) & 0xFF) / 255.0f, (hex & 0xFF) / 255.0f);
+}
 
+// RRGGBBAA to ImGui's AABBGGRR.
+uint32_t to_imgui_u32(uint32_t hex)
+{
+    const uint32_t r = (hex >> 24) & 0xFF;
+    const uint32_t g = (hex >> 16) & 0xFF;
+    const uint32_t b = (hex >> 8) & 0xFF;
+    const uint32_t a = hex & 0xFF;
+    return (a << 24) | (b << 16) | (g << 8) | r;
+}
+
+const core::color *find_color(const core::palette &pal, const std::string &key,
+                              const std::string &fallback)
+{
+    const auto &colors = pal.colors();
     auto it = colors.find(key);
     if (it == colors.end() && !fallback.empty())
-    {
         it = colors.find(fallback);
-    }
+    return it != colors.end() ? &it->second : nullptr;
+}
+} // namespace
 
-    if (it != colors.end())
-    {
-        const auto &col = it->second;
-        const uint32_t hex = col.hex();
-        const float r = ((hex >> 24) & 0xFF) / 255.0f;
-        const float g = ((hex >> 16) & 0xFF) / 255.0f;
-        const float b = ((hex >> 8) & 0xFF) / 255.0f;
-        const float a = (hex & 0xFF) / 255.0f;
-        return ImVec4(r, g, b, a);
-    }
-    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+ImVec4 palette_color(const core::palette &pal, const std::string &key,
+                     const std::string &fallback)
+{
+    const core::color *col = find_color(pal, key, fallback);
+    return col ? to_imvec4(col->hex()) : WHITE;
 }
 
 uint32_t palette_color_u32(const core::palette &pal, const std::string &key,
                            const std::string &fallback)
 {
-    auto colors = pal.colors();
-    if (colors.empty())
-        return 0xFFFFFFFF;
+    const core::color *col = find_color(pal, key, fallback);
+    return col ? to_imgui_u32(col->hex()) : 0xFFFFFFFF;
+}
 
-    auto it = colors.find(key);
-    if (it == colors.end() && !fallback.empty())
+resolved_palette::resolved_palette(const core::palette &pal) : m_empty(pal.colors().empty())
+{
+    const auto &colors = pal.colors();
+    for (size_t i = 0; i < core::NUM_COLOR_KEYS; ++i)
     {
-        it = colors.find(fallback);
+        auto &e = m_entries[i];
+        uint32_t hex = 0;
+        auto it = colors.find(core::COLOR_KEYS[i]);
+        if (it != colors.end())
+        {
+            hex = it->second.hex();
+            e.present = true;
+        }
+        else if (auto d = core::DEFAULT_COLORS.find(core::COLOR_KEYS[i]);
+                 d != core::DEFAULT_COLORS.end())
+        {
+            hex = d->second;
+        }
+        e.value = to_imvec4(hex);
+        e.value_u32 = to_imgui_u32(hex);
     }
+}
 
-    if (it != colors.end())
+size_t resolved_palette::index_of(std::string_view key)
+{
+    static const auto indices = [] {
+        std::unordered_map<std::string_view, size_t> map;
+        for (size_t i = 0; i < core::NUM_COLOR_KEYS; ++i)
+            map.emplace(core::COLOR_KEYS[i], i);
+        return map;
+    }();
+    auto it = indices.find(key);
+    return it != indices.end() ? it->second : core::NUM_COLOR_KEYS;
+}
+
+const resolved_palette::entry *resolved_palette::find(core::color_key key,
+                                                      core::color_key fallback) const
+{
+    for (core::color_key k : {key, fallback})
     {
-        const auto &col = it->second;
-        const uint32_t hex = col.hex();
-        const uint32_t r = (hex >> 24) & 0xFF;
-        const uint32_t g = (hex >> 16) & 0xFF;
-        const uint32_t b = (hex >> 8) & 0xFF;
-        const uint32_t a = hex & 0xFF;
-        return (a << 24) | (b << 16) | (g << 8) | r;
+        const size_t i = k.index();
+        if (i < core::NUM_COLOR_KEYS && m_entries[i].present)
+            return &m_entries[i];
     }
-    return 0xFFFFFFFF;
+    return nullptr;
+}
+
+ImVec4 resolved_palette::color(core::color_key key, core::color_key fallback) const
+{
+    const entry *e = find(key, fallback);
+    return e ? e->value : WHITE;
+}
+
+uint32_t resolved_palette::color_u32(core::color_key key, core::color_key fallback) const
+{
+    const entry *e = find(key, fallback);
+    return e ? e->value_u32 : 0xFFFFFFFF;
+}
+
+ImVec4 resolved_palette::color_or_default(core::color_key key) const
+{
+    return m_entries[key.index()].value;
 }
 
 } // namespace clrsync::gui::widgets
@@ -1,9 +1,12 @@
 #ifndef CLRSYNC_GUI_WIDGETS_COLORS_HPP
 #define CLRSYNC_GUI_WIDGETS_COLORS_HPP
 
+#include "core/palette/color_keys.hpp"
 #include "core/palette/palette.hpp"
 #include "imgui.h"
+#include <array>
 #include <string>
+#include <string_view>
 
 namespace clrsync::gui::widgets
 {
@@ -14,6 +17,44 @@ ImVec4 palette_color(const core::palette &pal, const std::string &key,
 uint32_t palette_color_u32(const core::palette &pal, const std::string &key,
                            const std::string &fallback = "");
 
+// A palette's colors converted once for drawing, indexed like core::COLOR_KEYS. Build it when
+// the palette changes; lookups during a frame neither allocate nor convert.
+class resolved_palette
+{
+  public:
+    resolved_palette() = default;
+    explicit resolved_palette(const core::palette &pal);
+
+    // Index of the key in core::COLOR_KEYS, or core::NUM_COLOR_KEYS if it is not one. For
+    // names only known at run time; keys named in code index the colors directly.
+    static size_t index_of(std::string_view key);
+
+    bool empty() const
+    {
+        return m_empty;
+    }
+
+    // Same lookup as palette_color(): the key, else the fallback, else white.
+    ImVec4 color(core::color_key key, core::color_key fallback = {}) const;
+    // Same as color(), packed the way ImGui draw lists and TextEditor palettes expect.
+    uint32_t color_u32(core::color_key key, core::color_key fallback = {}) const;
+    // Like palette::get_color(): keys missing from the palette take their default color.
+    ImVec4 color_or_default(core::color_key key) const;
+
+  private:
+    struct entry
+    {
+        ImVec4 value{1.0f, 1.0f, 1.0f, 1.0f};
+        uint32_t value_u32{0xFFFFFFFF};
+        bool present{false};
+    };
+
+    std::array<entry, core::NUM_COLOR_KEYS> m_entries{};
+    bool m_empty{true};
+
+    const entry *find(core::color_key key, core::color_key fallback) const;
+};
+
 } // namespace clrsync::gui::widgets
 
 #endif // CLRSYNC_GUI_WIDGETS_COLORS_HPP
@@ -6,13 +6,13 @@ namespace clrsync::gui::widgets
 {
 
 bool delete_confirmation_dialog(const std::string &popup_title, const std::string &item_name,
-                                const std::string &item_type, const core::palette &theme_palette,
+                                const std::string &item_type, const resolved_palette &theme_palette,
                                 const std::function<void()> &on_delete)
 {
     bool result = false;
     if (ImGui::BeginPopupModal(popup_title.c_str(), nullptr, ImGuiWindowFlags_AlwaysAutoResize))
     {
-        ImVec4 warning_color = palette_color(theme_palette, "warning", "accent");
+        ImVec4 warning_color = theme_palette.color("warning", "accent");
         ImGui::TextColored(warning_color, "Are you sure you want to delete '%s'?",
                            item_name.c_str());
         ImGui::Text("This action cannot be undone.");
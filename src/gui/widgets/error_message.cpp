@@ -25,15 +25,15 @@ const std::string& error_message::get() const
     return m_message;
 }
 
-void error_message::render(const core::palette& palette)
+void error_message::render(const resolved_palette& palette)
 {
     if (m_message.empty())
         return;
 
     ImGui::Spacing();
 
-    auto error_bg_color = palette_color(palette, "error");
-    auto error_text_color = palette_color(palette, "on_error");
+    auto error_bg_color = palette.color("error");
+    auto error_text_color = palette.color("on_error");
 
     ImGui::PushStyleColor(ImGuiCol_ChildBg, error_bg_color);
     ImGui::PushStyleColor(ImGuiCol_Border, error_bg_color);
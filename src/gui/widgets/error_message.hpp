@@ -1,7 +1,7 @@
 #ifndef CLRSYNC_GUI_WIDGETS_ERROR_MESSAGE_HPP
 #define CLRSYNC_GUI_WIDGETS_ERROR_MESSAGE_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 #include <string>
 
 namespace clrsync::gui::widgets
@@ -14,7 +14,7 @@ class error_message
     void clear();
     bool has_error() const;
     const std::string& get() const;
-    void render(const core::palette& palette);
+    void render(const resolved_palette& palette);
 
   private:
     std::string m_message;
@@ -1,13 +1,13 @@
 #ifndef CLRSYNC_GUI_WIDGETS_SECTION_HEADER_HPP
 #define CLRSYNC_GUI_WIDGETS_SECTION_HEADER_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 #include <string>
 
 namespace clrsync::gui::widgets
 {
 
-void section_header(const std::string& title, const core::palette& palette);
+void section_header(const std::string& title, const resolved_palette& palette);
 
 } // namespace clrsync::gui::widgets
 
@@ -1,7 +1,7 @@
 #ifndef CLRSYNC_GUI_WIDGETS_STYLED_CHECKBOX_HPP
 #define CLRSYNC_GUI_WIDGETS_STYLED_CHECKBOX_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 #include <functional>
 #include <string>
 
@@ -21,7 +21,7 @@ class styled_checkbox
   public:
     styled_checkbox();
 
-    bool render(const std::string &label, bool *value, const core::palette &theme_palette, 
+    bool render(const std::string &label, bool *value, const resolved_palette &theme_palette, 
                 checkbox_style style = checkbox_style::normal);
 
     void set_tooltip(const std::string &tooltip) { m_tooltip = tooltip; }
@@ -10,7 +10,7 @@ template_controls::template_controls() = default;
 
 void template_controls::render(template_control_state& state,
                                const template_control_callbacks& callbacks,
-                               const core::palette& palette,
+                               const resolved_palette& palette,
                                validation_message& validation)
 {
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 8));
@@ -28,7 +28,7 @@ void template_controls::render(template_control_state& state,
 
 void template_controls::render_action_buttons(template_control_state& state,
                                               const template_control_callbacks& callbacks,
-                                              const core::palette& palette)
+                                              const resolved_palette& palette)
 {
     if (ImGui::Button(" + New "))
     {
@@ -50,10 +50,10 @@ void template_controls::render_action_buttons(template_control_state& state,
     if (state.is_editing_existing)
     {
         ImGui::SameLine();
-        auto error = palette_color(palette, "error");
+        auto error = palette.color("error");
         auto error_hover = ImVec4(error.x * 1.1f, error.y * 1.1f, error.z * 1.1f, error.w);
         auto error_active = ImVec4(error.x * 0.8f, error.y * 0.8f, error.z * 0.8f, error.w);
-        auto on_error = palette_color(palette, "on_error");
+        auto on_error = palette.color("on_error");
         ImGui::PushStyleColor(ImGuiCol_Button, error);
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, error_hover);
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, error_active);
@@ -1,7 +1,7 @@
 #ifndef CLRSYNC_GUI_WIDGETS_TEMPLATE_CONTROLS_HPP
 #define CLRSYNC_GUI_WIDGETS_TEMPLATE_CONTROLS_HPP
 
-#include "core/palette/palette.hpp"
+#include "gui/widgets/colors.hpp"
 #include "gui/widgets/form_field.hpp"
 #include "gui/widgets/validation_message.hpp"
 #include <functional>
@@ -40,13 +40,13 @@ class template_controls
 
     void render(template_control_state& state,
                 const template_control_callbacks& callbacks,
-                const core::palette& palette,
+                const resolved_palette& palette,
                 validation_message& validation);
 
   private:
     void render_action_buttons(template_control_state& state,
                                const template_control_callbacks& callbacks,
-                               const core::palette& palette);
+                               const resolved_palette& palette);
 
     void render_fields(template_control_state& state,
                        const template_control_callbacks& callbacks);
@@ -25,13 +25,13 @@ const std::string& validation_message::get() const
     return m_message;
 }
 
-void validation_message::render(const core::palette& palette)
+void validation_message::render(const resolved_palette& palette)
 {
     if (m_message.empty())
         return;
 
     ImGui::Spacing();
-    ImVec4 error_color = palette_color(palette, "error", "accent");
+    ImVec4 error_color = palette.color("error", "accent");
     ImGui::PushStyleColor(ImGuiCol_Text, error_color);
     ImGui::TextWrapped("%s", m_message.c_str());
     ImGui::PopStyleColor();